@@ -112,6 +112,29 @@
 // If you have a two-axis machine, DON'T USE THIS. Instead, just alter the homing cycle for two-axes.
 #define HOMING_SINGLE_AXIS_COMMANDS // Default disabled. Uncomment to enable.
 
+// Enables a quick verify-home cycle. When the machine position is still trusted since the last
+// successful homing cycle (i.e. no aborted motion, hard limit, or homing failure has occurred since),
+// $H rapids each cycle's axes to HOMING_VERIFY_DISTANCE short of the known limit switch locations and
+// runs a single locate pass at the homing feed rate. If every switch trips within HOMING_VERIFY_TOLERANCE
+// of where it is expected, the position is accepted and pulled off as usual. Otherwise, or if any switch
+// trips early, Grbl falls back to the full search and locate homing cycle for those axes.
+// NOTE: The full homing cycle is always run after a power-up.
+// #define HOMING_VERIFY_CYCLE // Default disabled. Uncomment to enable.
+#define HOMING_VERIFY_DISTANCE 1.0 // mm. Must be greater than HOMING_VERIFY_TOLERANCE.
+#define HOMING_VERIFY_TOLERANCE 0.05 // mm
+
+// Enables the bed heightmap grid probing command and Z-compensated motion. '$P=X<len>Y<len>Z<depth>F<feed>'
+// probes a grid starting at the current position, which sets the grid origin and the Z clearance height.
+// Optional 'I<n>' and 'J<n>' words set the number of grid points along X and Y. The probed heights are
+// stored in RAM as int16 microns relative to the first grid point. While a heightmap is loaded, all
+// non-system line motions are split at the grid cell boundaries and their Z targets are offset by the
+// bilinear-interpolated height. '$P' prints the heightmap, '$PC' clears it and disables compensation,
+// '$PS' stores it in EEPROM, and '$PL' loads it back from EEPROM.
+// NOTE: Set the work Z zero at the grid origin, since heights are relative to the first grid point.
+// #define ENABLE_HEIGHTMAP // Default disabled. Uncomment to enable.
+#define HEIGHTMAP_MAX_POINTS_X 5 // Integer (2-6). Max grid points along X. Costs 2 bytes RAM per grid point.
+#define HEIGHTMAP_MAX_POINTS_Y 5 // Integer (2-6). Max grid points along Y.
+
 // Number of blocks Grbl executes upon startup. These blocks are stored in EEPROM, where the size
 // and addresses are defined in settings.h. With the current settings, up to 2 startup blocks may
 // be stored and executed in order. These startup blocks would typically be used to set the g-code
@@ -130,6 +153,17 @@
 #define N_DECIMAL_SETTINGVALUE    3 // Decimals for floating point setting values
 #define N_DECIMAL_RPMVALUE        0 // RPM value in rotations per min.
 
+// Formats the realtime status report position directly from step counts, scaled to report units
+// with one float multiply per axis and printed with integer digits, rather than converting to mm
+// and scaling each digit with float multiplies in printFloat(). The printed format is unchanged.
+// #define REPORT_INTEGER_POSITION // Default disabled. Uncomment to enable.
+
+// Captures the realtime status report position, executing line number, and feed rate together as
+// one snapshot consistent with a stepper ISR boundary, instead of reading each value separately
+// while steps execute. The line number and rate are then those of the segment actually executing,
+// rather than the head of the planner buffer and the last segment prepped ahead of the steppers.
+// #define REPORT_REALTIME_SNAPSHOT // Default disabled. Uncomment to enable.
+
 // Allows GRBL to track and report gcode line numbers.  Enabling this means that the planning buffer
 // goes from 16 to 15 to make room for the additional line number data in the plan_block_t struct
 #define USE_LINE_NUMBERS // Disabled by default. Uncomment to enable.
@@ -194,6 +228,30 @@
 #define REPORT_WCO_REFRESH_BUSY_COUNT 30  // (2-255)
 #define REPORT_WCO_REFRESH_IDLE_COUNT 10  // (2-255) Must be less than or equal to the busy count
 
+// Enables status reports pushed without a '?' request, driven by a watchdog timer tick (~16ms). Set
+// '$10' bit 2 (value 4) to push a report every STATUS_AUTO_REPORT_INTERVAL, and/or bit 3 (value 8) to
+// push a report whenever the machine state or executing line number changes. A push is deferred while
+// the serial TX buffer lacks room for a worst-case report without the WCO and override fields, and
+// those fields are left for a later report unless they fit too, so a pushed report never blocks.
+// NOTE: The watchdog oscillator is only accurate to about +/-10%. The interval is compile-time only,
+// since EEPROM has no room for another setting.
+// #define ENABLE_AUTO_STATUS_REPORT // Default disabled. Uncomment to enable.
+#define STATUS_AUTO_REPORT_INTERVAL 200 // Milliseconds (16-4000)
+
+// Enables continuous velocity jogging for pendants and joysticks. '$JV=X_Y_Z_F_' jogs along the
+// direction vector given by the axis words (normalized, so 'X1Y1' is a 45 degree diagonal) at speed F,
+// until changed by another '$JV=' line, stopped by a zero speed or direction, or canceled with the
+// jog cancel realtime command. Grbl keeps a few short rolling blocks queued ahead of the steppers, so
+// direction and speed changes take effect within about JOG_VELOCITY_BLOCKS*JOG_VELOCITY_BLOCK_TIME.
+// The host must resend '$JV=' or send a bare '$JV' keep-alive within JOG_VELOCITY_TIMEOUT, or Grbl
+// stops planning and the jog decelerates to a stop. The timeout is timed by the watchdog tick (see
+// ENABLE_AUTO_STATUS_REPORT), and jog speed is limited so the queued blocks hold no more than about
+// JOG_VELOCITY_TIMEOUT of motion. Soft limits end the jog at the last block that stays within travel.
+// #define ENABLE_VELOCITY_JOG // Default disabled. Uncomment to enable.
+#define JOG_VELOCITY_BLOCK_TIME 50 // Milliseconds of motion per rolling block at speed.
+#define JOG_VELOCITY_BLOCKS 3 // Rolling blocks kept queued (2 or more, less than planner buffer).
+#define JOG_VELOCITY_TIMEOUT 500 // Milliseconds without a keep-alive before planning stops (16-4000).
+
 // The temporal resolution of the acceleration management subsystem. A higher number gives smoother
 // acceleration, particularly noticeable on machines that run at very high feedrates, but may negatively
 // impact performance. The correct value for this parameter is machine dependent, so it's advised to
@@ -233,6 +291,16 @@
 // NOTE: Compute duty cycle at the minimum PWM by this equation: (% duty cycle)=(SPINDLE_PWM_MIN_VALUE/255)*100
 // #define SPINDLE_PWM_MIN_VALUE 5 // Default disabled. Uncomment to enable. Must be greater than zero. Integer (1-255).
 
+// Enables the spindle at-speed wait. When M3/M4 or an S change starts or alters a running spindle, Grbl
+// holds off the following motions until the spindle controller reports the actual RPM within 1000 RPM
+// of the goal RPM (the M105 '0k' band). This replaces fixed worst-case G4 dwells after spindle starts.
+// If the spindle doesn't reach speed within SPINDLE_AT_SPEED_TIMEOUT, Grbl issues an alarm (ALARM:7).
+// NOTE: The RPM status is sampled after SPINDLE_AT_SPEED_DELAY_MIN, so the spindle controller has time
+// to register the new goal RPM. Spindle stops (M5 or S0) never wait.
+// #define SPINDLE_WAIT_AT_SPEED // Default disabled. Uncomment to enable.
+#define SPINDLE_AT_SPEED_DELAY_MIN 0.2 // Float (seconds)
+#define SPINDLE_AT_SPEED_TIMEOUT 15.0 // Float (seconds)
+
 // With this enabled, Grbl sends back an echo of the line it has received, which has been pre-parsed (spaces
 // removed, capitalized letters, no comments) and is to be immediately executed by Grbl. Echoes will not be
 // sent upon a line buffer overflow, but should for all normal lines sent to Grbl. For example, if a user
@@ -279,6 +347,103 @@
 // time step. Also, keep in mind that the Arduino delay timer is not very accurate for long delays.
 #define DWELL_TIME_STEP 50 // Integer (1-255) (milliseconds)
 
+// Carries G4 dwells and spindle speed changes through the planner and step segment buffer, rather than
+// synchronizing (emptying) the planner buffer for each of them. A dwell becomes a timed, zero-motion
+// planner block, so the preceding motion decelerates to a stop at the dwell, but the planner continues
+// to look ahead past it. An S change of a running spindle is applied by the segment generator at the
+// start of the next planner block or dwell, via the per-segment spindle PWM.
+// NOTE: Spindle state changes (M3/M4/M5) and program flow (M0/M2/M30) still synchronize. An S change
+// with no following motion or dwell takes effect with the next one. S changes also synchronize, when
+// SPINDLE_WAIT_AT_SPEED is enabled.
+// #define PLAN_SPINDLE_AND_DWELL_EVENTS // Default disabled. Uncomment to enable.
+
+// Enables G64 path blending mode. 'G64 P<tol>' sets the corner tolerance used by the planner to
+// compute cornering speeds in place of the '$11' junction deviation, in the current units, until G61
+// restores exact path mode with '$11'. G64 without P (or P0) uses PATH_BLENDING_DEFAULT_TOLERANCE.
+// A negative P, or G64 in a block with another P word user (G4, G10, G38.x, G5, G73, G82, G83), is an error.
+// Roughing passes can then corner faster while finishing passes stay exact within one program.
+// NOTE: The tool still passes through each programmed corner point, as in G61. No blend arcs are
+// inserted. As with '$11', the tolerance only sets how fast the corner is taken.
+// #define ENABLE_PATH_BLENDING // Default disabled. Uncomment to enable.
+#define PATH_BLENDING_DEFAULT_TOLERANCE 0.05 // mm
+
+// Applies a separate acceleration and junction deviation to rapid (G0, G28, G30) motions, so retract
+// and traverse sequences aren't limited by the conservative cutting values. Rapids accelerate at
+// RAPID_ACCELERATION_PERCENT of the '$120'-'$122' axis accelerations. Corners between two rapids use
+// RAPID_JUNCTION_DEVIATION instead of '$11'. Corners between a rapid and a cutting motion keep the
+// cutting values.
+// NOTE: Settings EEPROM space is full, so these are compile-time values. Make sure the machine can
+// actually accelerate at the resulting rates, or it will lose steps on rapids. The default keeps the
+// '$120'-'$122' accelerations. Raise it only after testing the machine at the higher rate.
+// #define ENABLE_RAPID_MOTION_PROFILE // Default disabled. Uncomment to enable.
+#define RAPID_ACCELERATION_PERCENT 100 // Percent of axis acceleration settings (1-255)
+#define RAPID_JUNCTION_DEVIATION 0.05 // mm
+
+// Executes rapid (G0, G28, G30) motions as non-coordinated dogleg moves, rather than straight lines
+// where the slowest axis limits the others. A Z retract (positive Z) is moved first and a Z plunge
+// last. The XY move runs both axes at their own '$110'/'$111' max rates until one arrives, then the
+// other axis completes alone. Each leg is a normal planner block, so the speed at the dogleg corner is
+// set by the junction deviation, or the rapid profile above if enabled.
+// NOTE: The tool does not follow the straight line between the rapid endpoints. The path stays within
+// the box spanned by them, and XY travel is always at the higher Z.
+// #define ENABLE_DOGLEG_RAPIDS // Default disabled. Uncomment to enable.
+
+// Enables motion profiles selectable from g-code, so roughing and finishing can run with different
+// machine limits in one program. M100 selects the '$' settings. M101 to M10n select the profiles in
+// MOTION_PROFILES, which scale the '$110'-'$112' max rates and '$120'-'$122' accelerations per axis in
+// percent, and replace the '$11' junction deviation. The profile is carried with each planner block,
+// so a change takes effect at the next motion without a buffer sync or EEPROM write. Program end
+// (M2/M30) restores M100. A G64 P tolerance still takes precedence over the profile junction deviation.
+// G38.x probe motions always use the '$' settings. Dogleg rapids split legs at the profile max rates.
+// NOTE: Percentages above 100 exceed the '$' settings. Make sure the machine can actually achieve them.
+// #define ENABLE_MOTION_PROFILES // Default disabled. Uncomment to enable.
+#define N_MOTION_PROFILES 2 // Number of profiles, M101 and up (1-4)
+#define MOTION_PROFILES { \
+  /* { {Accel X,Y,Z %}, {Max rate X,Y,Z %}, Junction deviation mm } */ \
+  { {100,100,100}, {100,100,100}, 0.05 },  /* M101: Roughing. Faster cornering. */ \
+  { {50,50,50}, {100,100,100}, 0.005 }     /* M102: Finishing. Gentle acceleration and cornering. */ \
+}
+
+// Enables G5 cubic and G5.1 quadratic Bezier splines in the G17 XY plane, so curved toolpaths can be
+// sent as a few spline lines instead of hundreds of short G1 chords. G5 X Y I J P Q: I,J is the first
+// control point relative to the start and P,Q the second control point relative to the end. A G5
+// without I and J continues smoothly from the previous G5. G5.1 X Y I J: I,J is the control point
+// relative to the start. Like arcs, splines are split into chords within the '$12' arc tolerance by
+// the firmware. A Z word moves Z linearly along the spline.
+// #define ENABLE_SPLINES // Default disabled. Uncomment to enable.
+
+// Enables the G73, G81, G82, and G83 drilling canned cycles and the G98/G99 retract modes, so a CAM
+// post can send one line per hole instead of every peck as separate G0/G1 lines. Each hole rapids over
+// the XY position and down to the R plane, drills to Z, and rapids out to the starting height (G98) or
+// the R plane (G99). G82 dwells P seconds at the bottom. G83 drills in pecks of Q and retracts to the R
+// plane between them, G73 only backs off CANNED_CYCLE_PECK_CLEARANCE to break the chip. R, Z, Q, and P
+// carry over to the following holes of a series, and L repeats a hole, stepping by the XY increment in
+// G91. The cycle is expanded into normal planner moves as buffer space frees up.
+// NOTE: Only the G17 plane and G94 feed rate mode are supported. G80 or any other motion ends a series.
+// #define ENABLE_CANNED_CYCLES // Default disabled. Uncomment to enable.
+#define CANNED_CYCLE_PECK_CLEARANCE 0.25 // mm. G73 chip break back-off and G83 re-entry clearance.
+
+// Plans each G2/G3 arc as a single planner block, instead of splitting it into '$12' arc tolerance
+// chords that each take a planner buffer slot. The step segment generator follows the true arc at
+// segment resolution, and the planner limits the arc speed by its centripetal acceleration. Look-ahead
+// then spans whole arcs, so small radius arcs no longer starve the buffer and cap the feed rate.
+// NOTE: Arcs fall back to chords while a heightmap is loaded. Costs 13 bytes of RAM per planner block.
+// #define ENABLE_NATIVE_ARCS // Default disabled. Uncomment to enable.
+
+// Enables program mode between '%' lines, which mark the start and end of a streamed program. While a
+// program runs, an idle machine doesn't auto-start motion whenever the serial buffer runs dry. Motion
+// starts once the planner buffer is full, a command synchronizes the buffer, or the closing '%' is
+// received, so the program runs with full look-ahead from the first move. The opening '%' reports
+// [MSG:Pgm Start]. The closing '%' waits for the program motion to complete and reports the program
+// statistics [PGM:lines,errors,stops], where stops counts the times motion came to rest mid-program,
+// from buffer starvation or commands like M0, M30, G4, or spindle changes.
+// NOTE: M2/M30 synchronize the buffer as usual, but don't end program mode, since the closing '%'
+// would then open a new program. If no line arrives for PROGRAM_AUTO_START_TIMEOUT, queued motion is
+// auto-started anyway, so a program that is never closed with '%' doesn't strand it. Uses the watchdog
+// tick (see ENABLE_AUTO_STATUS_REPORT).
+// #define ENABLE_PROGRAM_MODE // Default disabled. Uncomment to enable.
+#define PROGRAM_AUTO_START_TIMEOUT 1000 // Milliseconds without a received line (16-4000)
+
 // Creates a delay between the direction pin setting and corresponding step pulse by creating
 // another interrupt (Timer2 compare) to manage it. The main Grbl interrupt (Timer1 compare)
 // sets the direction pins, and does not immediately set the stepper pins, as it would in
@@ -319,6 +484,23 @@
 // NOTE: See the included grblWrite_BuildInfo.ino example file to write this string seperately.
 #define ENABLE_BUILD_INFO_WRITE_COMMAND // '$I=' Default enabled. Comment to disable.
 
+// Enables the '$T' settings transaction command. The first '$T' opens a transaction, during which
+// '$x=val' settings changes take effect immediately but are not written to EEPROM. The next '$T'
+// commits the whole batch with a single pass and one checksum update. Useful for GUIs provisioning
+// many settings at once. Uncommitted changes are lost upon a power cycle. '$RST=$' and '$RST=*' restore
+// the default settings and close the transaction. '$RST=#' leaves it open.
+// #define ENABLE_SETTINGS_TRANSACTION // '$T' Default disabled. Uncomment to enable.
+
+// Enables the '$EB' EEPROM image dump and '$EW=' EEPROM block write commands, used to clone settings,
+// coordinate systems, calibration data, and notes onto another board. '$EB' prints the entire EEPROM
+// as '[EE:aaaa:dd..dd:cc]' lines, with the address and data in hex and a CRC-8 over both. Sending each
+// line back as '$EW=aaaa:dd..dd:cc' checks the CRC, writes the block, and verifies it by reading it
+// back. Data is hex encoded, since raw binary would collide with the realtime command characters.
+// NOTE: Once '$EW' writes settings or coordinate data, all commands other than '$E' report an
+// error until a reset (ctrl-x) reloads them from EEPROM.
+// #define ENABLE_EEPROM_IMAGE_COMMANDS // '$EB' and '$EW=' Default disabled. Uncomment to enable.
+#define EEPROM_IMAGE_BLOCK_SIZE 32 // Bytes per '$EB' line. Must divide EEPROM_SIZE. Max 32 to fit a line.
+
 // AVR processors require all interrupts to be disabled during an EEPROM write. This includes both
 // the stepper ISRs and serial comm ISRs. In the event of a long EEPROM write, this ISR pause can
 // cause active stepping to lose position and serial receive data to be lost. This configuration
@@ -333,6 +515,28 @@
 // job. At this time, this option only forces a planner buffer sync with these g-code commands.
 #define FORCE_BUFFER_SYNC_DURING_EEPROM_WRITE // Default enabled. Comment to disable.
 
+// Keeps all stored coordinate systems (G54-G59, G28, G30) in RAM after boot. G54-G59 switches, G10,
+// G28/G30, and '$#' reports then read RAM instead of reading and checksumming EEPROM each time.
+// Writes update RAM and are written through to EEPROM as before.
+// NOTE: Uses 96 bytes of RAM.
+// #define CACHE_COORDINATE_DATA // Default disabled. Uncomment to enable.
+
+// Appends coordinate system (G10, G28.1/G30.1) and calibration ('$LS') writes to a wear-leveling
+// journal in otherwise unused EEPROM, rather than rewriting the same cells for every job setup. The
+// newest record of each value is located upon boot. Only when the journal fills are the newest values
+// written back to their normal EEPROM locations and the journal erased.
+// NOTE: Uses 18 bytes of RAM and EEPROM bytes 87-386.
+// #define ENABLE_EEPROM_JOURNAL // Default disabled. Uncomment to enable.
+
+// Queues EEPROM writes in RAM and programs them one byte at a time from the EEPROM ready interrupt,
+// instead of disabling all interrupts while busy-waiting on each byte. Stepper and serial ISRs keep
+// running during G10 L2/L20, G28.1/G30.1, and '$' setting writes, so the buffer sync above is skipped
+// and these commands no longer stop motion. Reads check the queue first and always return the newest
+// value. When the queue is full, a write waits with interrupts enabled for an entry to drain.
+// NOTE: Each queue entry uses 3 bytes of RAM. A full coordinate system write needs 13 entries.
+// #define EEPROM_WRITE_QUEUE // Default disabled. Uncomment to enable.
+#define EEPROM_WRITE_QUEUE_SIZE 16 // Number of queued EEPROM bytes. Max 255.
+
 // In Grbl v0.9 and prior, there is an old outstanding bug where the `WPos:` work position reported
 // may not correlate to what is executing, because `WPos:` is based on the g-code parser state, which
 // can be several motions behind. This option forces the planner buffer to empty, sync, and stop
@@ -348,6 +552,22 @@
 // repeatable. If needed, you can disable this behavior by uncommenting the define below.
 // #define ALLOW_FEED_OVERRIDE_DURING_PROBE_CYCLES // Default disabled. Uncomment to enable.
 
+// By default, the probe trip position is the step position at the first stepper ISR tick after the
+// probe pin interrupt, so its resolution is one step tick. This option timestamps the probe pin edge
+// against the stepper Timer1 count and interpolates the trip position within the step tick, using
+// the Bresenham state of the executing segment. This keeps the probe position accurate to a fraction
+// of a step at higher probing feed rates. Reported positions ([PRB:]) include the sub-step offset.
+// NOTE: Adds about 30 bytes of RAM and a small amount of probe pin ISR overhead.
+// #define PROBE_SUBSTEP_INTERPOLATION // Default disabled. Uncomment to enable.
+
+// Enables two-speed probing from a single G38.x block, e.g. 'G38.2 Z-20 F300 P30 R1'. When a P word
+// is passed, the probe seeks at the F feed rate, retracts from the trip position by the R word distance
+// (or PROBE_LOCATE_RETRACT_DISTANCE, if omitted) and then locates the probe again at the slower P feed
+// rate, all without host round-trips. Only the final locate position is reported and stored.
+// NOTE: P and R are in the current units (G20/G21). The locate motion uses the original G38.x target.
+// #define ENABLE_TWO_SPEED_PROBE // Default disabled. Uncomment to enable.
+#define PROBE_LOCATE_RETRACT_DISTANCE 1.0 // mm. Must be positive.
+
 /* ---------------------------------------------------------------------------------------
    OEM Single File Configuration Option
 
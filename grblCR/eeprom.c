@@ -23,6 +23,7 @@
 ****************************************************************************/
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include "grbl.h"
 
 /* These EEPROM bits have different names on different devices. */
 #ifndef EEPE
@@ -37,54 +38,42 @@
 /* Define to reduce code size. */
 #define EEPROM_IGNORE_SELFPROG //!< Remove SPM flag polling.
 
-/*! \brief  Read byte from EEPROM.
- *
- *  This function reads one byte from a given EEPROM address.
- *
- *  \note  The CPU is halted for 4 clock cycles during EEPROM read.
- *
- *  \param  addr  EEPROM address to read from.
- *  \return  The byte read from the EEPROM address.
- */
-unsigned char eeprom_get_char( unsigned int addr )
-{
-	do {} while( EECR & (1<<EEPE) ); // Wait for completion of previous write.
-	EEAR = addr; // Set EEPROM address register.
-	EECR = (1<<EERE); // Start EEPROM read operation.
-	return EEDR; // Return the byte read from EEPROM.
-}
+#ifdef EEPROM_WRITE_QUEUE
+	/* Write-behind queue of pending EEPROM bytes. Drained by the EE_READY interrupt. */
+	typedef struct {
+		unsigned int addr;   //!< EEPROM address to write to.
+		unsigned char value; //!< New EEPROM value.
+	} eeprom_write_t;
+	static eeprom_write_t eeprom_queue[EEPROM_WRITE_QUEUE_SIZE];
+	static volatile uint8_t eeprom_queue_head; //!< Index of the next free queue entry.
+	static volatile uint8_t eeprom_queue_tail; //!< Index of the oldest pending queue entry.
+#endif
 
-/*! \brief  Write byte to EEPROM.
+/*! \brief  Program byte to EEPROM.
  *
- *  This function writes one byte to a given EEPROM address.
  *  The differences between the existing byte and the new value is used
- *  to select the most efficient EEPROM programming mode.
- *
- *  \note  The CPU is halted for 2 clock cycles during EEPROM programming.
+ *  to select the most efficient EEPROM programming mode. The caller must
+ *  disable interrupts and ensure no previous write is in progress.
  *
- *  \note  When this function returns, the new EEPROM value is not available
- *         until the EEPROM programming time has passed. The EEPE bit in EECR
- *         should be polled to check whether the programming is finished.
- *
- *  \note  The EEPROM_GetChar() function checks the EEPE bit automatically.
+ *  \note  The EERIE bit is preserved, so the EE_READY interrupt stays
+ *         enabled while a write queue is being drained.
  *
  *  \param  addr  EEPROM address to write to.
  *  \param  new_value  New EEPROM value.
+ *  \return  Non-zero if a programming operation was started.
  */
-void eeprom_put_char( unsigned int addr, unsigned char new_value )
+static unsigned char eeprom_program_char( unsigned int addr, unsigned char new_value )
 {
 	char old_value; // Old EEPROM value.
 	char diff_mask; // Difference mask, i.e. old value XOR new value.
+	unsigned char eerie = EECR & (1<<EERIE); // Keep EE_READY interrupt state.
 
-	cli(); // Ensure atomic operation for the write operation.
-	
-	do {} while( EECR & (1<<EEPE) ); // Wait for completion of previous write.
 	#ifndef EEPROM_IGNORE_SELFPROG
 	do {} while( SPMCSR & (1<<SELFPRGEN) ); // Wait for completion of SPM.
 	#endif
 	
 	EEAR = addr; // Set EEPROM address register.
-	EECR = (1<<EERE); // Start EEPROM read operation.
+	EECR |= (1<<EERE); // Start EEPROM read operation.
 	old_value = EEDR; // Get old EEPROM value.
 	diff_mask = old_value ^ new_value; // Get bit differences.
 	
@@ -97,16 +86,17 @@ void eeprom_put_char( unsigned int addr, unsigned char new_value )
 			// Now we know that some bits need to be programmed to '0' also.
 			
 			EEDR = new_value; // Set EEPROM data register.
-			EECR = (1<<EEMPE) | // Set Master Write Enable bit...
+			EECR = eerie | (1<<EEMPE) | // Set Master Write Enable bit...
 			       (0<<EEPM1) | (0<<EEPM0); // ...and Erase+Write mode.
 			EECR |= (1<<EEPE);  // Start Erase+Write operation.
 		} else {
 			// Now we know that all bits should be erased.
 
-			EECR = (1<<EEMPE) | // Set Master Write Enable bit...
+			EECR = eerie | (1<<EEMPE) | // Set Master Write Enable bit...
 			       (1<<EEPM0);  // ...and Erase-only mode.
 			EECR |= (1<<EEPE);  // Start Erase-only operation.
 		}
+		return 1;
 	} else {
 		// Now we know that _no_ bits need to be erased to '1'.
 		
@@ -115,13 +105,153 @@ void eeprom_put_char( unsigned int addr, unsigned char new_value )
 			// Now we know that _some_ bits need to the programmed to '0'.
 			
 			EEDR = new_value;   // Set EEPROM data register.
-			EECR = (1<<EEMPE) | // Set Master Write Enable bit...
+			EECR = eerie | (1<<EEMPE) | // Set Master Write Enable bit...
 			       (1<<EEPM1);  // ...and Write-only mode.
 			EECR |= (1<<EEPE);  // Start Write-only operation.
+			return 1;
 		}
 	}
-	
-	sei(); // Restore interrupt flag state.
+	return 0;
+}
+
+#ifdef EEPROM_WRITE_QUEUE
+/*! \brief  Start the next queued EEPROM write.
+ *
+ *  Pops queue entries until one actually changes the EEPROM contents and
+ *  starts programming it. Disables the EE_READY interrupt once the queue
+ *  is empty. Must be called with interrupts disabled and EEPE clear.
+ */
+static void eeprom_queue_start_next( void )
+{
+	while( eeprom_queue_tail != eeprom_queue_head ) {
+		eeprom_write_t *entry = &eeprom_queue[eeprom_queue_tail];
+		if( ++eeprom_queue_tail == EEPROM_WRITE_QUEUE_SIZE ) { eeprom_queue_tail = 0; }
+		if( eeprom_program_char(entry->addr, entry->value) ) { return; } // Wait for next EE_READY.
+	}
+	EECR &= ~(1<<EERIE); // Queue empty. Disable EE_READY interrupt.
+}
+
+/*! \brief  Find the newest pending value for an EEPROM address.
+ *
+ *  \return  Pointer to the queue entry, or 0 if the address is not pending.
+ */
+static eeprom_write_t *eeprom_queue_find( unsigned int addr )
+{
+	uint8_t index = eeprom_queue_head;
+	while( index != eeprom_queue_tail ) {
+		if( index == 0 ) { index = EEPROM_WRITE_QUEUE_SIZE; }
+		index--;
+		if( eeprom_queue[index].addr == addr ) { return(&eeprom_queue[index]); }
+	}
+	return(0);
+}
+
+/*! \brief  EEPROM ready interrupt.
+ *
+ *  Fires when the previous EEPROM write has completed and programs the next
+ *  queued byte. Only this one byte is written per interrupt, so the stepper
+ *  and serial interrupts are never held off for an EEPROM programming time.
+ */
+ISR(EE_READY_vect)
+{
+	eeprom_queue_start_next();
+}
+
+/*! \brief  Wait until all queued EEPROM writes have been programmed. */
+void eeprom_flush( void )
+{
+	do {} while( eeprom_queue_tail != eeprom_queue_head );
+	do {} while( EECR & (1<<EEPE) ); // Wait for completion of last write.
+}
+#endif
+
+/*! \brief  Read byte from EEPROM.
+ *
+ *  This function reads one byte from a given EEPROM address.
+ *
+ *  \note  The CPU is halted for 4 clock cycles during EEPROM read.
+ *
+ *  \note  With the write queue enabled, pending values are returned from the
+ *         queue so reads stay coherent with writes not yet programmed.
+ *
+ *  \param  addr  EEPROM address to read from.
+ *  \return  The byte read from the EEPROM address.
+ */
+unsigned char eeprom_get_char( unsigned int addr )
+{
+	#ifdef EEPROM_WRITE_QUEUE
+		unsigned char data;
+		uint8_t sreg = SREG;
+		for (;;) {
+			cli(); // Queue lookup and EEPROM read must not race the EE_READY interrupt.
+			eeprom_write_t *entry = eeprom_queue_find(addr);
+			if( entry ) { data = entry->value; break; }
+			if( !(EECR & (1<<EEPE)) ) {
+				EEAR = addr; // Set EEPROM address register.
+				EECR |= (1<<EERE); // Start EEPROM read operation.
+				data = EEDR;
+				break;
+			}
+			SREG = sreg; // Write in progress. Let interrupts run while waiting.
+		}
+		SREG = sreg;
+		return data;
+	#else
+		do {} while( EECR & (1<<EEPE) ); // Wait for completion of previous write.
+		EEAR = addr; // Set EEPROM address register.
+		EECR |= (1<<EERE); // Start EEPROM read operation.
+		return EEDR; // Return the byte read from EEPROM.
+	#endif
+}
+
+/*! \brief  Write byte to EEPROM.
+ *
+ *  This function writes one byte to a given EEPROM address.
+ *
+ *  \note  The CPU is halted for 2 clock cycles during EEPROM programming.
+ *
+ *  \note  When this function returns, the new EEPROM value is not available
+ *         until the EEPROM programming time has passed. The EEPE bit in EECR
+ *         should be polled to check whether the programming is finished.
+ *
+ *  \note  The EEPROM_GetChar() function checks the EEPE bit automatically.
+ *
+ *  \note  With the write queue enabled, the byte is only queued and programmed
+ *         later by the EE_READY interrupt. A value already pending for the same
+ *         address is replaced. Interrupts stay enabled unless the queue is full
+ *         and a queued write has to be started here instead.
+ *
+ *  \param  addr  EEPROM address to write to.
+ *  \param  new_value  New EEPROM value.
+ */
+void eeprom_put_char( unsigned int addr, unsigned char new_value )
+{
+	#ifdef EEPROM_WRITE_QUEUE
+		uint8_t sreg = SREG;
+		for (;;) {
+			cli(); // Ensure atomic operation on the write queue.
+			eeprom_write_t *entry = eeprom_queue_find(addr);
+			if( entry ) { entry->value = new_value; break; } // Replace pending value.
+			uint8_t next_head = eeprom_queue_head+1;
+			if( next_head == EEPROM_WRITE_QUEUE_SIZE ) { next_head = 0; }
+			if( next_head != eeprom_queue_tail ) {
+				eeprom_queue[eeprom_queue_head].addr = addr;
+				eeprom_queue[eeprom_queue_head].value = new_value;
+				eeprom_queue_head = next_head;
+				break;
+			}
+			// Queue full. Start the oldest write here in case the EE_READY interrupt can't run.
+			if( !(EECR & (1<<EEPE)) ) { eeprom_queue_start_next(); }
+			SREG = sreg;
+		}
+		EECR |= (1<<EERIE); // Enable EE_READY interrupt to drain the queue.
+		SREG = sreg; // Restore interrupt flag state.
+	#else
+		cli(); // Ensure atomic operation for the write operation.
+		do {} while( EECR & (1<<EEPE) ); // Wait for completion of previous write.
+		eeprom_program_char(addr, new_value);
+		sei(); // Restore interrupt flag state.
+	#endif
 }
 
 // Extensions added as part of Grbl 
@@ -137,6 +267,19 @@ void memcpy_to_eeprom_with_checksum(unsigned int destination, char *source, unsi
   eeprom_put_char(destination, checksum);
 }
 
+// Same as memcpy_to_eeprom_with_checksum(), but only the bytes of source chunks flagged in
+// dirty_mask are written. The checksum still covers all of source and is written once.
+void memcpy_dirty_to_eeprom_with_checksum(unsigned int destination, char *source, unsigned int size, unsigned char chunk_size, unsigned char dirty_mask) {
+  unsigned char checksum = 0;
+  unsigned int idx;
+  for(idx = 0; idx < size; idx++) {
+    checksum = (checksum << 1) || (checksum >> 7);
+    checksum += source[idx];
+    if (dirty_mask & (1 << (idx/chunk_size))) { eeprom_put_char(destination+idx, source[idx]); }
+  }
+  eeprom_put_char(destination+size, checksum);
+}
+
 int memcpy_from_eeprom_with_checksum(char *destination, unsigned int source, unsigned int size) {
   unsigned char data, checksum = 0;
   for(; size > 0; size--) { 
@@ -25,5 +25,11 @@ unsigned char eeprom_get_char(unsigned int addr);
 void eeprom_put_char(unsigned int addr, unsigned char new_value);
 void memcpy_to_eeprom_with_checksum(unsigned int destination, char *source, unsigned int size);
 int memcpy_from_eeprom_with_checksum(char *destination, unsigned int source, unsigned int size);
+void memcpy_dirty_to_eeprom_with_checksum(unsigned int destination, char *source, unsigned int size, unsigned char chunk_size, unsigned char dirty_mask);
+
+#ifdef EEPROM_WRITE_QUEUE
+  // Blocks until all queued EEPROM writes have been programmed.
+  void eeprom_flush();
+#endif
 
 #endif
@@ -32,6 +32,12 @@
 #define AXIS_COMMAND_MOTION_MODE 2
 #define AXIS_COMMAND_TOOL_LENGTH_OFFSET 3 // *Undefined but required
 
+#ifdef ENABLE_CANNED_CYCLES
+  // True for the G73, G81, G82, and G83 canned cycle motion modes.
+  #define gc_is_canned_cycle(motion) (((motion) == MOTION_MODE_DRILL_CHIP_BREAK) || \
+    (((motion) >= MOTION_MODE_DRILL) && ((motion) <= MOTION_MODE_DRILL_PECK)))
+#endif
+
 // Declare gc extern struct
 parser_state_t gc_state;
 parser_block_t gc_block;
@@ -87,6 +93,8 @@ uint8_t gc_execute_line(char *line)
   uint16_t command_words = 0; // Tracks G and M command words. Also used for modal group violations.
   uint16_t value_words = 0; // Tracks value words.
   uint8_t gc_parser_flags = GC_PARSER_NONE;
+  float probe_locate_rate = 0.0; // Two-speed probe locate feed rate. Zero for single-speed probing.
+  float probe_retract = 0.0;     // Two-speed probe retract distance.
 
   // Determine if the line is a jogging motion or a normal g-code block.
   if (line[0] == '$') { // NOTE: `$J=` already parsed when passed to this function.
@@ -161,6 +169,12 @@ uint8_t gc_execute_line(char *line)
             }
             break;
           case 0: case 1: case 2: case 3: case 38:
+          #ifdef ENABLE_SPLINES
+          case 5:
+          #endif
+          #ifdef ENABLE_CANNED_CYCLES
+          case 73: case 81: case 82: case 83:
+          #endif
             // Check for G0/G1/G2/G3/G38 being called with G10/G28/G30/G92 on same block.
             // * G43.1 is also an axis command but is not explicitly defined this way.
             if (axis_command) { FAIL(STATUS_GCODE_AXIS_COMMAND_CONFLICT); } // [Axis word/command conflict]
@@ -176,6 +190,12 @@ uint8_t gc_execute_line(char *line)
               gc_block.modal.motion += (mantissa/10)+100;
               mantissa = 0; // Set to zero to indicate valid non-integer G command.
             }  
+            #ifdef ENABLE_SPLINES
+              if ((int_value == 5) && (mantissa == 10)) { // G5.1
+                gc_block.modal.motion = MOTION_MODE_QUADRATIC_SPLINE;
+                mantissa = 0; // Set to zero to indicate valid non-integer G command.
+              }
+            #endif
             break;
           case 17: case 18: case 19: //G17 G18 G19
             word_bit = MODAL_GROUP_G2;
@@ -225,11 +245,26 @@ uint8_t gc_execute_line(char *line)
             word_bit = MODAL_GROUP_G12;
             gc_block.modal.coord_select = int_value - 54; // Shift to array indexing.
             break;
+          #ifdef ENABLE_PATH_BLENDING
+          case 61: case 64: //G61 G64
+            word_bit = MODAL_GROUP_G13;
+            if (mantissa != 0) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [G61.1 not supported]
+            if (int_value == 61) { gc_block.modal.control = CONTROL_MODE_EXACT_PATH; } // G61
+            else { gc_block.modal.control = CONTROL_MODE_CONTINUOUS; } // G64
+            break;
+          #else
           case 61: //G61
             word_bit = MODAL_GROUP_G13;
             if (mantissa != 0) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [G61.1 not supported]
             // gc_block.modal.control = CONTROL_MODE_EXACT_PATH; // G61
             break;
+          #endif
+          #ifdef ENABLE_CANNED_CYCLES
+          case 98: case 99: //G98 G99
+            word_bit = MODAL_GROUP_G10;
+            gc_block.modal.retract = int_value - 98;
+            break;
+          #endif
           default: FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); // [Unsupported G command]
         }
         if (mantissa > 0) { FAIL(STATUS_GCODE_COMMAND_VALUE_NOT_INTEGER); } // [Unsupported or invalid Gxx.x command]
@@ -276,6 +311,13 @@ uint8_t gc_execute_line(char *line)
             //'3k': Spindle actualRPM beyond 3000      of goalRPM
             sys.report_ok_mode = REPORT_RESPONSE_0K_1K_2K_3K;
             break;
+          #ifdef ENABLE_MOTION_PROFILES
+          case 100: case 101: case 102: case 103: case 104: //M100-M104 //select motion profile
+            word_bit = MODAL_GROUP_M10;
+            if (int_value-100 > N_MOTION_PROFILES) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [Undefined profile]
+            gc_block.modal.motion_profile = int_value-100;
+            break;
+          #endif
 
           default: FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); // [Unsupported M command]
         }
@@ -302,11 +344,23 @@ uint8_t gc_execute_line(char *line)
           case 'I': word_bit = WORD_I; gc_block.values.ijk[X_AXIS] = value; ijk_words |= (1<<X_AXIS); break;
           case 'J': word_bit = WORD_J; gc_block.values.ijk[Y_AXIS] = value; ijk_words |= (1<<Y_AXIS); break;
           case 'K': word_bit = WORD_K; gc_block.values.ijk[Z_AXIS] = value; ijk_words |= (1<<Z_AXIS); break;
-          case 'L': word_bit = WORD_L; gc_block.values.l = int_value; break;
+          case 'L': word_bit = WORD_L;
+            #ifdef ENABLE_CANNED_CYCLES
+              // L is also a canned cycle repeat count. Check the value itself, not its uint8_t truncation.
+              if (value < 0.0) { FAIL(STATUS_NEGATIVE_VALUE); }
+              if (value > 255.0) { FAIL(STATUS_GCODE_MAX_VALUE_EXCEEDED); }
+              if (value != int_value) { FAIL(STATUS_GCODE_COMMAND_VALUE_NOT_INTEGER); }
+            #endif
+            gc_block.values.l = int_value;
+            break;
           case 'N': word_bit = WORD_N; gc_block.values.n = trunc(value); break;
           case 'P': word_bit = WORD_P; gc_block.values.p = value; break;
           // NOTE: For certain commands, P value must be an integer, but none of these commands are supported.
+          #if defined(ENABLE_CANNED_CYCLES) || defined(ENABLE_SPLINES)
+          case 'Q': word_bit = WORD_Q; gc_block.values.q = value; break;
+          #else
           // case 'Q': // Not supported
+          #endif
           case 'R': word_bit = WORD_R; gc_block.values.r = value; break;
           case 'S': word_bit = WORD_S; gc_block.values.s = value; break;
           case 'T': word_bit = WORD_T; 
@@ -323,7 +377,12 @@ uint8_t gc_execute_line(char *line)
         if (bit_istrue(value_words,bit(word_bit))) { FAIL(STATUS_GCODE_WORD_REPEATED); } // [Word repeated]
         // Check for invalid negative values for words F, N, P, T, and S.
         // NOTE: Negative value check is done here simply for code-efficiency.
-        if ( bit(word_bit) & (bit(WORD_F)|bit(WORD_N)|bit(WORD_P)|bit(WORD_T)|bit(WORD_S)) ) {
+        #ifdef ENABLE_SPLINES
+          // NOTE: The G5 P word is a signed control point offset. P is checked after parsing instead.
+          if ( bit(word_bit) & (bit(WORD_F)|bit(WORD_N)|bit(WORD_T)|bit(WORD_S)) ) {
+        #else
+          if ( bit(word_bit) & (bit(WORD_F)|bit(WORD_N)|bit(WORD_P)|bit(WORD_T)|bit(WORD_S)) ) {
+        #endif
           if (value < 0.0) { FAIL(STATUS_NEGATIVE_VALUE); } // [Word value cannot be negative]
         }
         value_words |= bit(word_bit); // Flag to indicate parameter assigned.
@@ -360,6 +419,11 @@ uint8_t gc_execute_line(char *line)
   */
 
   // [0. Non-specific/common error-checks and miscellaneous setup]:
+  #ifdef ENABLE_SPLINES
+    // P may only be negative as a G5 control point offset, which no non-modal command shares.
+    if ((gc_block.values.p < 0.0) && ((gc_block.modal.motion != MOTION_MODE_CUBIC_SPLINE) ||
+        (gc_block.non_modal_command != NON_MODAL_NO_ACTION))) { FAIL(STATUS_NEGATIVE_VALUE); }
+  #endif
 
   // Determine implicit axis command conditions. Axis words have been passed, but no explicit axis
   // command has been sent. If so, set axis command to current motion mode.
@@ -497,9 +561,42 @@ uint8_t gc_execute_line(char *line)
     }
   }
 
-  // [16. Set path control mode ]: N/A. Only G61. G61.1 and G64 NOT SUPPORTED.
+  #ifdef ENABLE_PATH_BLENDING
+    // [16. Set path control mode ]: G61.1 NOT SUPPORTED. G64 P tolerance is negative.
+    // [G64 Errors]: G4, G10, G38.x, G5, G73, G82, or G83 in same block. These commands also use the P word.
+    float path_tolerance = gc_state.path_tolerance;
+    if ( bit_istrue(command_words,bit(MODAL_GROUP_G13)) && (gc_block.modal.control == CONTROL_MODE_CONTINUOUS) ) {
+      if ( (gc_block.non_modal_command == NON_MODAL_DWELL) || (gc_block.non_modal_command == NON_MODAL_SET_COORDINATE_DATA) ) {
+        FAIL(STATUS_GCODE_MODAL_GROUP_VIOLATION);
+      }
+      if (axis_command == AXIS_COMMAND_MOTION_MODE) {
+        switch (gc_block.modal.motion) {
+          case MOTION_MODE_PROBE_TOWARD: case MOTION_MODE_PROBE_TOWARD_NO_ERROR:
+          case MOTION_MODE_PROBE_AWAY: case MOTION_MODE_PROBE_AWAY_NO_ERROR:
+          case MOTION_MODE_CUBIC_SPLINE: case MOTION_MODE_DRILL_CHIP_BREAK:
+          case MOTION_MODE_DRILL_DWELL: case MOTION_MODE_DRILL_PECK:
+            FAIL(STATUS_GCODE_MODAL_GROUP_VIOLATION);
+        }
+      }
+      path_tolerance = PATH_BLENDING_DEFAULT_TOLERANCE;
+      if (bit_istrue(value_words,bit(WORD_P))) {
+        if (gc_block.values.p < 0.0) { FAIL(STATUS_NEGATIVE_VALUE); }
+        if (gc_block.values.p > 0.0) {
+          path_tolerance = gc_block.values.p;
+          if (gc_block.modal.units == UNITS_MODE_INCHES) { path_tolerance *= MM_PER_INCH; }
+        }
+        bit_false(value_words,bit(WORD_P));
+      }
+    }
+  #else
+    // [16. Set path control mode ]: N/A. Only G61. G61.1 and G64 NOT SUPPORTED.
+  #endif
   // [17. Set distance mode ]: N/A. Only G91.1. G90.1 NOT SUPPORTED.
-  // [18. Set retract mode ]: NOT SUPPORTED.
+  #ifdef ENABLE_CANNED_CYCLES
+    // [18. Set retract mode ]: N/A
+  #else
+    // [18. Set retract mode ]: NOT SUPPORTED.
+  #endif
 
   // [19. Remaining non-modal actions ]: Check go to predefined position, set G10, or set axis offsets.
   // NOTE: We need to separate the non-modal commands that are axis word-using (G10/G28/G30/G92), as these
@@ -804,7 +901,117 @@ uint8_t gc_execute_line(char *line)
           //   allow the planner buffer to empty and move off the probe trigger before another probing cycle.
           if (!axis_words) { FAIL(STATUS_GCODE_NO_AXIS_WORDS); } // [No axis words]
           if (isequal_position_vector(gc_state.position, gc_block.values.xyz)) { FAIL(STATUS_GCODE_INVALID_TARGET); } // [Invalid target]
+          #ifdef ENABLE_TWO_SPEED_PROBE
+            // [G38 two-speed]: P word sets locate feed rate. R word sets optional retract distance.
+            //   P is zero or negative (done). R is zero or negative. R without P is an unused word.
+            if (bit_istrue(value_words,bit(WORD_P))) {
+              if (gc_block.values.p == 0.0) { FAIL(STATUS_GCODE_UNDEFINED_FEED_RATE); } // [Locate feed rate undefined]
+              probe_locate_rate = gc_block.values.p;
+              probe_retract = PROBE_LOCATE_RETRACT_DISTANCE;
+              if (bit_istrue(value_words,bit(WORD_R))) {
+                if (gc_block.values.r <= 0.0) { FAIL(STATUS_NEGATIVE_VALUE); } // [Retract distance not positive]
+                probe_retract = gc_block.values.r;
+                if (gc_block.modal.units == UNITS_MODE_INCHES) { probe_retract *= MM_PER_INCH; }
+              }
+              if (gc_block.modal.units == UNITS_MODE_INCHES) { probe_locate_rate *= MM_PER_INCH; }
+              bit_false(value_words,(bit(WORD_P)|bit(WORD_R)));
+            }
+          #endif
+          break;
+        #ifdef ENABLE_SPLINES
+        case MOTION_MODE_CUBIC_SPLINE: case MOTION_MODE_QUADRATIC_SPLINE:
+          // [G5/G5.1 Errors]: Plane is not G17. No axis words. Feed rate undefined (done.)
+          //   [G5]: P or Q missing. Only one of I and J. I and J missing without a preceding G5.
+          //   [G5.1]: I and J missing.
+          // NOTE: The G5 control point offsets are passed in i,j (first, from the start) and p,q (second,
+          //   from the target). A G5.1 quadratic spline is elevated here to the identical cubic spline,
+          //   whose control points are 2/3 of the way from each end to the quadratic control point.
+          if (gc_block.modal.plane_select != PLANE_SELECT_XY) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [G18/G19 not supported]
+          if (!axis_words) { FAIL(STATUS_GCODE_NO_AXIS_WORDS); } // [No axis words]
+          if (gc_block.modal.units == UNITS_MODE_INCHES) {
+            gc_block.values.ijk[X_AXIS] *= MM_PER_INCH;
+            gc_block.values.ijk[Y_AXIS] *= MM_PER_INCH;
+            gc_block.values.p *= MM_PER_INCH;
+            gc_block.values.q *= MM_PER_INCH;
+          }
+          if (gc_block.modal.motion == MOTION_MODE_CUBIC_SPLINE) {
+            if (bit_isfalse(value_words,bit(WORD_P)) || bit_isfalse(value_words,bit(WORD_Q))) { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [P or Q missing]
+            if (!(ijk_words & (bit(X_AXIS)|bit(Y_AXIS)))) {
+              // Continue from the preceding G5 with its second control point reflected through the start.
+              if (gc_state.modal.motion != MOTION_MODE_CUBIC_SPLINE) { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [I and J missing]
+              gc_block.values.ijk[X_AXIS] = -gc_state.spline_offset[X_AXIS];
+              gc_block.values.ijk[Y_AXIS] = -gc_state.spline_offset[Y_AXIS];
+            } else if ((ijk_words & (bit(X_AXIS)|bit(Y_AXIS))) != (bit(X_AXIS)|bit(Y_AXIS))) {
+              FAIL(STATUS_GCODE_VALUE_WORD_MISSING); // [Only one of I and J]
+            }
+            bit_false(value_words,(bit(WORD_P)|bit(WORD_Q)));
+          } else { // G5.1
+            if (!(ijk_words & (bit(X_AXIS)|bit(Y_AXIS)))) { FAIL(STATUS_GCODE_NO_OFFSETS_IN_PLANE); } // [I and J missing]
+            gc_block.values.p = (gc_state.position[X_AXIS]+gc_block.values.ijk[X_AXIS]-gc_block.values.xyz[X_AXIS])*(2.0/3.0);
+            gc_block.values.q = (gc_state.position[Y_AXIS]+gc_block.values.ijk[Y_AXIS]-gc_block.values.xyz[Y_AXIS])*(2.0/3.0);
+            gc_block.values.ijk[X_AXIS] *= (2.0/3.0);
+            gc_block.values.ijk[Y_AXIS] *= (2.0/3.0);
+          }
+          bit_false(value_words,(bit(WORD_I)|bit(WORD_J)));
+          break;
+        #endif
+        #ifdef ENABLE_CANNED_CYCLES
+        case MOTION_MODE_DRILL_CHIP_BREAK: case MOTION_MODE_DRILL:
+        case MOTION_MODE_DRILL_DWELL: case MOTION_MODE_DRILL_PECK:
+          // [G73/G81/G82/G83 Errors]: Plane is not G17. Inverse time mode. R or Z missing for the first hole
+          //   of a series. Q missing for G73/G83. Q or L not positive. Hole bottom above the R plane.
+          //   P is negative (done.) Axis words are optional. If missing, set axis command flag to ignore execution.
+          // NOTE: R, Z, Q, and P are kept from the previous hole when the last motion was also a canned cycle.
+          //   In G90, R and Z are heights in the work coordinate system. In G91, R is relative to the current
+          //   Z position and Z is relative to the R plane. The programmed R and Z are kept in r and k. The R
+          //   plane and retract height are pre-computed into i and j, and the hole bottom into the Z target,
+          //   all in machine coordinates. By rule, ijk values are not in use with these commands.
+          if (!axis_words) { axis_command = AXIS_COMMAND_NONE; break; }
+          if (gc_block.modal.plane_select != PLANE_SELECT_XY) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [G18/G19 not supported]
+          if (gc_block.modal.feed_rate == FEED_RATE_MODE_INVERSE_TIME) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [G93 not supported]
+          uint8_t cycle_series = gc_is_canned_cycle(gc_state.modal.motion);
+
+          if (bit_istrue(value_words,bit(WORD_R))) {
+            if (gc_block.modal.units == UNITS_MODE_INCHES) { gc_block.values.r *= MM_PER_INCH; }
+          } else if (cycle_series) { gc_block.values.r = gc_state.cycle_r; }
+          else { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [R word missing]
+
+          float z_offset = block_coord_system[Z_AXIS]+gc_state.coord_offset[Z_AXIS];
+          if (TOOL_LENGTH_OFFSET_AXIS == Z_AXIS) { z_offset += gc_state.tool_length_offset; }
+          if (bit_istrue(axis_words,bit(Z_AXIS))) { // Recover the programmed Z from the pre-computed target.
+            if (gc_block.modal.distance == DISTANCE_MODE_INCREMENTAL) {
+              gc_block.values.ijk[Z_AXIS] = gc_block.values.xyz[Z_AXIS]-gc_state.position[Z_AXIS];
+            } else {
+              gc_block.values.ijk[Z_AXIS] = gc_block.values.xyz[Z_AXIS]-z_offset;
+            }
+          } else if (cycle_series) { gc_block.values.ijk[Z_AXIS] = gc_state.cycle_z; }
+          else { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [Z word missing]
+
+          if (bit_istrue(value_words,bit(WORD_Q))) {
+            if (gc_block.values.q <= 0.0) { FAIL(STATUS_NEGATIVE_VALUE); } // [Q not positive]
+            if (gc_block.modal.units == UNITS_MODE_INCHES) { gc_block.values.q *= MM_PER_INCH; }
+          } else if (cycle_series) { gc_block.values.q = gc_state.cycle_q; }
+          if ((gc_block.values.q == 0.0) && ((gc_block.modal.motion == MOTION_MODE_DRILL_PECK) ||
+              (gc_block.modal.motion == MOTION_MODE_DRILL_CHIP_BREAK))) { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [Q word missing]
+          if (bit_isfalse(value_words,bit(WORD_P)) && cycle_series) { gc_block.values.p = gc_state.cycle_p; }
+
+          if (bit_istrue(value_words,bit(WORD_L))) {
+            if (gc_block.values.l == 0) { FAIL(STATUS_NEGATIVE_VALUE); } // [L not positive]
+          } else { gc_block.values.l = 1; }
+          bit_false(value_words,(bit(WORD_L)|bit(WORD_P)|bit(WORD_Q)|bit(WORD_R)));
+
+          if (gc_block.modal.distance == DISTANCE_MODE_INCREMENTAL) {
+            gc_block.values.ijk[X_AXIS] = gc_state.position[Z_AXIS]+gc_block.values.r;
+            gc_block.values.xyz[Z_AXIS] = gc_block.values.ijk[X_AXIS]+gc_block.values.ijk[Z_AXIS];
+          } else {
+            gc_block.values.ijk[X_AXIS] = gc_block.values.r+z_offset;
+            gc_block.values.xyz[Z_AXIS] = gc_block.values.ijk[Z_AXIS]+z_offset;
+          }
+          if (gc_block.values.xyz[Z_AXIS] > gc_block.values.ijk[X_AXIS]) { FAIL(STATUS_GCODE_INVALID_TARGET); } // [Bottom above R plane]
+          if (gc_block.modal.retract == RETRACT_MODE_R) { gc_block.values.ijk[Y_AXIS] = gc_block.values.ijk[X_AXIS]; } // G99
+          else { gc_block.values.ijk[Y_AXIS] = max(gc_state.position[Z_AXIS],gc_block.values.ijk[X_AXIS]); } // G98
           break;
+        #endif
       }
     }
   }
@@ -871,6 +1078,9 @@ uint8_t gc_execute_line(char *line)
 
   // [4. Set spindle speed ]:
   if ( (gc_state.spindle_speed != gc_block.values.s) || bit_istrue(gc_parser_flags,GC_PARSER_LASER_FORCE_SYNC) ) {
+    // NOTE: With planner spindle events, the new speed is applied by the segment generator when the
+    // next planner block begins. Spindle state changes are synced below in [7. Spindle control ].
+    #if !defined(PLAN_SPINDLE_AND_DWELL_EVENTS) || defined(SPINDLE_WAIT_AT_SPEED)
     if (gc_state.modal.spindle != SPINDLE_DISABLE) { 
       if (bit_isfalse(gc_parser_flags,GC_PARSER_LASER_ISMOTION)) {
         if (bit_istrue(gc_parser_flags,GC_PARSER_LASER_DISABLE)) {
@@ -878,6 +1088,7 @@ uint8_t gc_execute_line(char *line)
         } else { spindle_sync(gc_state.modal.spindle, gc_block.values.s); }
       }
     }
+    #endif
     gc_state.spindle_speed = gc_block.values.s; // Update spindle speed state.
   }
   // NOTE: Pass zero spindle speed for all restricted laser motions.
@@ -900,8 +1111,14 @@ uint8_t gc_execute_line(char *line)
   }
   pl_data->condition |= gc_state.modal.spindle; // Set condition flag for planner use.
 
+  #ifdef ENABLE_MOTION_PROFILES
+    // [9. Motion profile selection ]: Applied by the planner to the motions of this block onward.
+    gc_state.modal.motion_profile = gc_block.modal.motion_profile;
+    pl_data->motion_profile = gc_state.modal.motion_profile;
+  #endif
+
   // [10. Dwell ]:
-  if (gc_block.non_modal_command == NON_MODAL_DWELL) { mc_dwell(gc_block.values.p); }
+  if (gc_block.non_modal_command == NON_MODAL_DWELL) { mc_dwell(gc_block.values.p, pl_data); }
 
   // [11. Set active plane ]:
   gc_state.modal.plane_select = gc_block.modal.plane_select;
@@ -934,13 +1151,25 @@ uint8_t gc_execute_line(char *line)
     system_flag_wco_change();
   }
 
-  // [16. Set path control mode ]: G61.1/G64 NOT SUPPORTED
-  // gc_state.modal.control = gc_block.modal.control; // NOTE: Always default.
+  #ifdef ENABLE_PATH_BLENDING
+    // [16. Set path control mode ]: G61.1 NOT SUPPORTED
+    gc_state.modal.control = gc_block.modal.control;
+    gc_state.path_tolerance = path_tolerance;
+    if (gc_state.modal.control == CONTROL_MODE_CONTINUOUS) { pl_data->junction_deviation = gc_state.path_tolerance; }
+  #else
+    // [16. Set path control mode ]: G61.1/G64 NOT SUPPORTED
+    // gc_state.modal.control = gc_block.modal.control; // NOTE: Always default.
+  #endif
 
   // [17. Set distance mode ]:
   gc_state.modal.distance = gc_block.modal.distance;
 
-  // [18. Set retract mode ]: NOT SUPPORTED
+  #ifdef ENABLE_CANNED_CYCLES
+    // [18. Set retract mode ]:
+    gc_state.modal.retract = gc_block.modal.retract;
+  #else
+    // [18. Set retract mode ]: NOT SUPPORTED
+  #endif
 
   // [19. Go to predefined position, Set G10, or Set axis offsets ]:
   switch(gc_block.non_modal_command) {
@@ -992,13 +1221,43 @@ uint8_t gc_execute_line(char *line)
       } else if ((gc_state.modal.motion == MOTION_MODE_CW_ARC) || (gc_state.modal.motion == MOTION_MODE_CCW_ARC)) {
         mc_arc(gc_block.values.xyz, pl_data, gc_state.position, gc_block.values.ijk, gc_block.values.r,
             axis_0, axis_1, axis_linear, bit_istrue(gc_parser_flags,GC_PARSER_ARC_IS_CLOCKWISE));
+      #ifdef ENABLE_SPLINES
+      } else if ((gc_state.modal.motion == MOTION_MODE_CUBIC_SPLINE) || (gc_state.modal.motion == MOTION_MODE_QUADRATIC_SPLINE)) {
+        gc_state.spline_offset[X_AXIS] = gc_block.values.p;
+        gc_state.spline_offset[Y_AXIS] = gc_block.values.q;
+        mc_spline(gc_block.values.xyz, pl_data, gc_state.position, gc_block.values.ijk, gc_state.spline_offset);
+      #endif
+      #ifdef ENABLE_CANNED_CYCLES
+      } else if (gc_is_canned_cycle(gc_state.modal.motion)) {
+        gc_state.cycle_r = gc_block.values.r;
+        gc_state.cycle_z = gc_block.values.ijk[Z_AXIS];
+        gc_state.cycle_q = gc_block.values.q;
+        gc_state.cycle_p = gc_block.values.p;
+        // L repeats the hole. In G91, each repeat is offset again by the programmed XY increment.
+        float step_x = 0.0;
+        float step_y = 0.0;
+        if (gc_state.modal.distance == DISTANCE_MODE_INCREMENTAL) {
+          step_x = gc_block.values.xyz[X_AXIS]-gc_state.position[X_AXIS];
+          step_y = gc_block.values.xyz[Y_AXIS]-gc_state.position[Y_AXIS];
+        }
+        do {
+          mc_canned_cycle(gc_block.values.xyz, pl_data, gc_state.position, gc_state.modal.motion,
+              gc_block.values.ijk[X_AXIS], gc_block.values.ijk[Y_AXIS], gc_block.values.q, gc_block.values.p);
+          gc_state.position[X_AXIS] = gc_block.values.xyz[X_AXIS];
+          gc_state.position[Y_AXIS] = gc_block.values.xyz[Y_AXIS];
+          gc_state.position[Z_AXIS] = gc_block.values.ijk[Y_AXIS]; // Tool ends at the retract height.
+          gc_block.values.xyz[X_AXIS] += step_x;
+          gc_block.values.xyz[Y_AXIS] += step_y;
+        } while (--gc_block.values.l);
+        gc_update_pos = GC_UPDATE_POS_NONE;
+      #endif
       } else {
         // NOTE: gc_block.values.xyz is returned from mc_probe_cycle with the updated position value. So
         // upon a successful probing cycle, the machine position and the returned value should be the same.
         #ifndef ALLOW_FEED_OVERRIDE_DURING_PROBE_CYCLES
           pl_data->condition |= PL_COND_FLAG_NO_FEED_OVERRIDE;
         #endif
-        gc_update_pos = mc_probe_cycle(gc_block.values.xyz, pl_data, gc_parser_flags);
+        gc_update_pos = mc_probe_cycle(gc_block.values.xyz, pl_data, gc_parser_flags, probe_locate_rate, probe_retract);
       }  
      
       // As far as the parser is concerned, the position is now == target. In reality the
@@ -1035,6 +1294,9 @@ uint8_t gc_execute_line(char *line)
       // gc_state.modal.cutter_comp = CUTTER_COMP_DISABLE; // Not supported.
       gc_state.modal.coord_select = 0; // G54
       gc_state.modal.spindle = SPINDLE_DISABLE;
+      #ifdef ENABLE_MOTION_PROFILES
+        gc_state.modal.motion_profile = 0; // M100. Next program starts with the '$' settings.
+      #endif
 
       #ifdef RESTORE_OVERRIDES_AFTER_PROGRAM_END
         sys.f_override = DEFAULT_FEED_OVERRIDE;
@@ -1053,8 +1315,6 @@ uint8_t gc_execute_line(char *line)
     gc_state.modal.program_flow = PROGRAM_FLOW_RUNNING; // Reset program flow.
   }
 
-  // TODO: % to denote start of program.
-
   return(STATUS_OK);
 }
 
@@ -1062,7 +1322,8 @@ uint8_t gc_execute_line(char *line)
 /*
   Not supported:
 
-  - Canned cycles
+  - Canned cycles, other than G73 and G81-G83 (ENABLE_CANNED_CYCLES)
+  - Splines, other than G5 and G5.1 (ENABLE_SPLINES)
   - Tool radius compensation
   - A,B,C-axes
   - Evaluation of expressions
@@ -30,7 +30,7 @@
 // and are similar/identical to other g-code interpreters by manufacturers (Haas,Fanuc,Mazak,etc).
 // NOTE: Modal group define values must be sequential and starting from zero.
 #define MODAL_GROUP_G0 0 // [G4,G10,G28,G28.1,G30,G30.1,G53,G92,G92.1] Non-modal
-#define MODAL_GROUP_G1 1 // [G0,G1,G2,G3,G38.2,G38.3,G38.4,G38.5,G80] Motion
+#define MODAL_GROUP_G1 1 // [G0,G1,G2,G3,G5,G5.1,G38.2,G38.3,G38.4,G38.5,G73,G80,G81,G82,G83] Motion
 #define MODAL_GROUP_G2 2 // [G17,G18,G19] Plane selection
 #define MODAL_GROUP_G3 3 // [G90,G91] Distance mode
 #define MODAL_GROUP_G4 4 // [G91.1] Arc IJK distance mode
@@ -43,7 +43,9 @@
 
 #define MODAL_GROUP_M4 11  // [M0,M1,M2,M30] Stopping
 #define MODAL_GROUP_M7 12 // [M3,M4,M5] Spindle turning
+#define MODAL_GROUP_M10 13 // [M100-M104] Motion profile
 #define MODAL_GROUP_M9 14 // [M56] Override control
+#define MODAL_GROUP_G10 15 // [G98,G99] Canned cycle retract mode
 
 // Define command actions for within execution-type modal groups (motion, stopping, non-modal). Used
 // internally by the parser to know which command to execute.
@@ -69,11 +71,17 @@
 #define MOTION_MODE_LINEAR 1 // G1 (Do not alter value)
 #define MOTION_MODE_CW_ARC 2  // G2 (Do not alter value)
 #define MOTION_MODE_CCW_ARC 3  // G3 (Do not alter value)
+#define MOTION_MODE_CUBIC_SPLINE 5 // G5 (Do not alter value)
+#define MOTION_MODE_QUADRATIC_SPLINE 51 // G5.1 (Do not alter value)
 #define MOTION_MODE_PROBE_TOWARD 140 // G38.2 (Do not alter value)
 #define MOTION_MODE_PROBE_TOWARD_NO_ERROR 141 // G38.3 (Do not alter value)
 #define MOTION_MODE_PROBE_AWAY 142 // G38.4 (Do not alter value)
 #define MOTION_MODE_PROBE_AWAY_NO_ERROR 143 // G38.5 (Do not alter value)
 #define MOTION_MODE_NONE 80 // G80 (Do not alter value)
+#define MOTION_MODE_DRILL_CHIP_BREAK 73 // G73 (Do not alter value)
+#define MOTION_MODE_DRILL 81 // G81 (Do not alter value)
+#define MOTION_MODE_DRILL_DWELL 82 // G82 (Do not alter value)
+#define MOTION_MODE_DRILL_PECK 83 // G83 (Do not alter value)
 
 // Modal Group G2: Plane select
 #define PLANE_SELECT_XY 0 // G17 (Default: Must be zero)
@@ -107,6 +115,11 @@
 
 // Modal Group G13: Control mode
 #define CONTROL_MODE_EXACT_PATH 0 // G61 (Default: Must be zero)
+#define CONTROL_MODE_CONTINUOUS 1 // G64
+
+// Modal Group G10: Canned cycle retract mode
+#define RETRACT_MODE_INITIAL 0 // G98 (Default: Must be zero)
+#define RETRACT_MODE_R 1 // G99 (Do not alter value)
 
 // Modal Group M7: Spindle control
 #define SPINDLE_DISABLE 0 // M5 (Default: Must be zero)
@@ -128,12 +141,13 @@
 #define WORD_L  4
 #define WORD_N  5
 #define WORD_P  6
-#define WORD_R  7
-#define WORD_S  8
-#define WORD_T  9
-#define WORD_X  10
-#define WORD_Y  11
-#define WORD_Z  12
+#define WORD_Q  7
+#define WORD_R  8
+#define WORD_S  9
+#define WORD_T  10
+#define WORD_X  11
+#define WORD_Y  12
+#define WORD_Z  13
 
 // Define g-code parser position updating flags
 #define GC_UPDATE_POS_TARGET   0 // Must be zero
@@ -165,7 +179,7 @@
 
 // NOTE: When this struct is zeroed, the above defines set the defaults for the system.
 typedef struct {
-  uint8_t motion;          // {G0,G1,G2,G3,G38.2,G80}
+  uint8_t motion;          // {G0,G1,G2,G3,G5,G5.1,G38.2,G73,G80,G81,G82,G83}
   uint8_t feed_rate;       // {G93,G94}
   uint8_t units;           // {G20,G21}
   uint8_t distance;        // {G90,G91}
@@ -174,10 +188,20 @@ typedef struct {
   // uint8_t cutter_comp;  // {G40} NOTE: Don't track. Only default supported.
   uint8_t tool_length;     // {G43.1,G49}
   uint8_t coord_select;    // {G54,G55,G56,G57,G58,G59}
-  // uint8_t control;      // {G61} NOTE: Don't track. Only default supported.
+  #ifdef ENABLE_PATH_BLENDING
+    uint8_t control;       // {G61,G64}
+  #else
+    // uint8_t control;    // {G61} NOTE: Don't track. Only default supported.
+  #endif
+  #ifdef ENABLE_CANNED_CYCLES
+    uint8_t retract;       // {G98,G99}
+  #endif
   uint8_t program_flow;    // {M0,M1,M2,M30}
   uint8_t spindle;         // {M3,M4,M5}
   uint8_t override;        // {M56}
+  #ifdef ENABLE_MOTION_PROFILES
+    uint8_t motion_profile; // {M100,M101,M102,M103,M104}
+  #endif
 } gc_modal_t;
 
 typedef struct {
@@ -186,7 +210,11 @@ typedef struct {
   uint8_t l;       // G10 or canned cycles parameters
   int32_t n;       // Line number
   float p;         // G10 or dwell parameters
-  // float q;      // G82 peck drilling
+  #if defined(ENABLE_CANNED_CYCLES) || defined(ENABLE_SPLINES)
+    float q;       // G73/G83 peck increment or G5 control point
+  #else
+    // float q;    // G82 peck drilling
+  #endif
   float r;         // Arc radius
   float s;         // Spindle speed
   uint8_t t;       // Tool selection
@@ -209,6 +237,19 @@ typedef struct {
   float coord_offset[N_AXIS];    // Retains the G92 coordinate offset (work coordinates) relative to
                                  // machine zero in mm. Non-persistent. Cleared upon reset and boot.
   float tool_length_offset;      // Tracks tool length offset value when enabled.
+  #ifdef ENABLE_PATH_BLENDING
+    float path_tolerance;        // G64 P corner tolerance in mm.
+  #endif
+  #ifdef ENABLE_SPLINES
+    float spline_offset[2];      // Second control point offset of the last G5. Reflected by a following G5
+                                 // without I and J, so consecutive splines join smoothly.
+  #endif
+  #ifdef ENABLE_CANNED_CYCLES
+    float cycle_r;               // Canned cycle R, Z, Q, and P words of the current series in mm and
+    float cycle_z;               // seconds. Reused by the following holes, when not programmed.
+    float cycle_q;
+    float cycle_p;
+  #endif
 } parser_state_t;
 extern parser_state_t gc_state;
 
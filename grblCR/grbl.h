@@ -68,6 +68,36 @@
   #error "Required HOMING_CYCLE_0 not defined."
 #endif
 
+#ifdef ENABLE_HEIGHTMAP
+  #if (HEIGHTMAP_MAX_POINTS_X < 2) || (HEIGHTMAP_MAX_POINTS_Y < 2)
+    #error "Heightmap requires at least two grid points along each axis."
+  #endif
+  #if (HEIGHTMAP_MAX_POINTS_X*HEIGHTMAP_MAX_POINTS_Y > 36)
+    #error "Heightmap grid exceeds reserved EEPROM space. 36 grid points max."
+  #endif
+#endif
+
+#ifdef ENABLE_MOTION_PROFILES
+  #if (N_MOTION_PROFILES < 1) || (N_MOTION_PROFILES > 4)
+    #error "N_MOTION_PROFILES must be 1 to 4. M105 is already in use."
+  #endif
+#endif
+
+#ifdef ENABLE_VELOCITY_JOG
+  #if (JOG_VELOCITY_BLOCKS < 2) || (JOG_VELOCITY_BLOCKS >= BLOCK_BUFFER_SIZE-1)
+    #error "JOG_VELOCITY_BLOCKS must be 2 or more and less than the planner buffer size."
+  #endif
+  #if (JOG_VELOCITY_TIMEOUT/JOG_VELOCITY_BLOCK_TIME < 1) || (JOG_VELOCITY_TIMEOUT/JOG_VELOCITY_BLOCK_TIME > 255)
+    #error "JOG_VELOCITY_TIMEOUT must be 1 to 255 times JOG_VELOCITY_BLOCK_TIME."
+  #endif
+#endif
+
+#ifdef ENABLE_EEPROM_IMAGE_COMMANDS
+  #if (EEPROM_IMAGE_BLOCK_SIZE > 32) || (EEPROM_SIZE % EEPROM_IMAGE_BLOCK_SIZE)
+    #error "EEPROM_IMAGE_BLOCK_SIZE must divide EEPROM_SIZE and be 32 or less to fit a '$EW=' line."
+  #endif
+#endif
+
 #if defined(SPINDLE_PWM_MIN_VALUE)
   #if !(SPINDLE_PWM_MIN_VALUE > 0)
     #error "SPINDLE_PWM_MIN_VALUE must be greater than zero."
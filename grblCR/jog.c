@@ -48,3 +48,164 @@ uint8_t jog_execute(plan_line_data_t *pl_data, parser_block_t *gc_block)
 
   return(STATUS_OK);
 }
+
+
+#ifdef ENABLE_VELOCITY_JOG
+typedef struct {
+  float unit_vec[N_AXIS];   // Jog direction unit vector
+  float target[N_AXIS];     // Target of the last planned velocity jog block (mm)
+  float feed_rate;          // Jog speed (mm/min)
+  float block_mm;           // Length of each rolling jog block (mm)
+  uint8_t active;           // True while velocity jog mode is planning blocks
+  uint8_t planning;         // Blocks re-entry from protocol_execute_realtime() while planning
+  uint8_t expired;          // True once the keep-alive timed out or soft limits ended planning
+  uint8_t keep_alive_tick;  // sys_tick at the last keep-alive
+} jog_velocity_t;
+static jog_velocity_t jog_velocity;
+
+
+void jog_velocity_stop()
+{
+  jog_velocity.active = false;
+}
+
+
+// Plans rolling velocity jog blocks until JOG_VELOCITY_BLOCKS are queued in the planner. Planning
+// ends when the keep-alive times out or the next block would exceed the soft limits. The planner
+// always plans the last queued block to stop, so the jog then decelerates to a stop on its own.
+static void jog_velocity_plan()
+{
+  plan_line_data_t plan_data;
+  float target[N_AXIS];
+  uint8_t idx;
+  jog_velocity.planning = true;
+  while (!jog_velocity.expired && (plan_get_block_buffer_count() < JOG_VELOCITY_BLOCKS)) {
+    if ((uint8_t)(sys_tick-jog_velocity.keep_alive_tick) >= (JOG_VELOCITY_TIMEOUT/SYSTEM_TICK_MS)) {
+      jog_velocity.expired = true;
+      break;
+    }
+    for (idx=0; idx<N_AXIS; idx++) {
+      target[idx] = jog_velocity.target[idx] + jog_velocity.unit_vec[idx]*jog_velocity.block_mm;
+    }
+    if (bit_istrue(settings.flags,BITFLAG_SOFT_LIMIT_ENABLE)) {
+      if (system_check_travel_limits(target)) { jog_velocity.expired = true; break; }
+    }
+
+    // NOTE: Spindle is allowed to fully function with overrides during a jog, same as '$J='.
+    memset(&plan_data,0,sizeof(plan_line_data_t));
+    plan_data.feed_rate = jog_velocity.feed_rate;
+    plan_data.spindle_speed = gc_state.spindle_speed;
+    plan_data.condition = gc_state.modal.spindle | PL_COND_FLAG_NO_FEED_OVERRIDE;
+    #ifdef USE_LINE_NUMBERS
+      plan_data.line_number = JOG_LINE_NUMBER;
+    #endif
+    mc_line(target,&plan_data);
+    if (sys.abort) { break; }
+
+    // Track the parser position, so a '$J=' following the velocity jog starts from its end.
+    memcpy(jog_velocity.target,target,sizeof(target));
+    memcpy(gc_state.position,target,sizeof(target));
+  }
+  jog_velocity.planning = false;
+}
+
+
+void jog_velocity_update()
+{
+  if (!jog_velocity.active || jog_velocity.planning) { return; }
+  // Jog completed, timed out, or canceled. Any hold or jog cancel ends velocity jog mode.
+  if ((sys.state != STATE_JOG) || sys.suspend || sys.abort) {
+    jog_velocity.active = false;
+    return;
+  }
+  jog_velocity_plan();
+}
+
+
+// Executes a velocity jog line. '$JV=X_Y_Z_F_' sets the jog direction from the axis words, which
+// are normalized to a unit vector, at speed F in the current units mode. Axis words not given are
+// zero. '$JV' alone is a keep-alive that renews the timeout. A zero direction or speed stops the
+// jog immediately, same as a jog cancel realtime command.
+uint8_t jog_velocity_execute(char *line)
+{
+  // Execute only if in IDLE or JOG states.
+  if (sys.state != STATE_IDLE && sys.state != STATE_JOG) { return(STATUS_IDLE_ERROR); }
+
+  uint8_t char_counter = 3; // Skip '$JV'
+  if (line[char_counter] == 0) {
+    if (!jog_velocity.active) { return(STATUS_INVALID_JOG_COMMAND); }
+    jog_velocity.keep_alive_tick = sys_tick;
+    jog_velocity.expired = false;
+    return(STATUS_OK);
+  }
+  if (line[char_counter++] != '=') { return(STATUS_INVALID_STATEMENT); }
+
+  float vec[N_AXIS] = {0.0};
+  float feed_rate = 0.0;
+  uint8_t feed_word = false;
+  uint8_t idx;
+  char letter;
+  float value;
+  while (line[char_counter] != 0) {
+    letter = line[char_counter++];
+    if (!read_float(line,&char_counter,&value)) { return(STATUS_BAD_NUMBER_FORMAT); }
+    switch (letter) {
+      case 'X': vec[X_AXIS] = value; break;
+      case 'Y': vec[Y_AXIS] = value; break;
+      case 'Z': vec[Z_AXIS] = value; break;
+      case 'F':
+        if (value < 0.0) { return(STATUS_NEGATIVE_VALUE); }
+        feed_rate = value;
+        feed_word = true;
+        break;
+      default: return(STATUS_INVALID_JOG_COMMAND);
+    }
+  }
+  if (!feed_word) { return(STATUS_INVALID_JOG_COMMAND); }
+
+  float magnitude = 0.0;
+  for (idx=0; idx<N_AXIS; idx++) { magnitude += vec[idx]*vec[idx]; }
+  if ((magnitude == 0.0) || (feed_rate == 0.0)) {
+    // Stop. Decelerate now, rather than after the queued blocks.
+    if (jog_velocity.active && (sys.state == STATE_JOG)) { system_set_exec_state_flag(EXEC_MOTION_CANCEL); }
+    jog_velocity.active = false;
+    return(STATUS_OK);
+  }
+  magnitude = sqrt(magnitude);
+  for (idx=0; idx<N_AXIS; idx++) { jog_velocity.unit_vec[idx] = vec[idx]/magnitude; }
+  if (gc_state.modal.units == UNITS_MODE_INCHES) { feed_rate *= MM_PER_INCH; }
+
+  // Size the rolling blocks to last JOG_VELOCITY_BLOCK_TIME at speed, but long enough that the
+  // queued blocks behind the executing one can always stop from speed. Otherwise the planner
+  // would never let the jog reach its requested speed. Stopping distance grows with the square of
+  // speed, so speed is also limited to keep the queued blocks within JOG_VELOCITY_TIMEOUT at speed.
+  float max_rate = limit_value_by_axis_maximum(settings.max_rate,jog_velocity.unit_vec);
+  if (feed_rate > max_rate) { feed_rate = max_rate; }
+  float acceleration = limit_value_by_axis_maximum(settings.acceleration,jog_velocity.unit_vec);
+  max_rate = acceleration*(2.0*(JOG_VELOCITY_BLOCKS-1)*JOG_VELOCITY_TIMEOUT/(60000.0*JOG_VELOCITY_BLOCKS));
+  if (feed_rate > max_rate) { feed_rate = max_rate; }
+  jog_velocity.feed_rate = feed_rate;
+  jog_velocity.block_mm = feed_rate*(JOG_VELOCITY_BLOCK_TIME/60000.0);
+  value = (feed_rate*feed_rate)/(2.0*acceleration*(JOG_VELOCITY_BLOCKS-1));
+  if (value > jog_velocity.block_mm) { jog_velocity.block_mm = value; }
+
+  // A new velocity jog continues from the parser position, which follows any '$J=' jog targets.
+  if (!jog_velocity.active) { memcpy(jog_velocity.target,gc_state.position,sizeof(gc_state.position)); }
+  jog_velocity.active = true;
+  jog_velocity.keep_alive_tick = sys_tick;
+  jog_velocity.expired = false;
+
+  jog_velocity_plan();
+  if (sys.state == STATE_IDLE) {
+    if (plan_get_current_block() != NULL) { // Check if there is a block to execute.
+      sys.state = STATE_JOG;
+      st_prep_buffer();
+      st_wake_up();  // NOTE: Manual start. No state machine required.
+    } else {
+      jog_velocity.active = false; // Nothing planned. At a soft limit.
+    }
+  }
+
+  return(STATUS_OK);
+}
+#endif
@@ -29,4 +29,15 @@
 // Sets up valid jog motion received from g-code parser, checks for soft-limits, and executes the jog.
 uint8_t jog_execute(plan_line_data_t *pl_data, parser_block_t *gc_block);
 
+#ifdef ENABLE_VELOCITY_JOG
+  // Starts, updates, stops, or keeps alive a velocity jog from a '$JV' line.
+  uint8_t jog_velocity_execute(char *line);
+
+  // Keeps the rolling velocity jog blocks queued. Called by protocol_execute_realtime().
+  void jog_velocity_update();
+
+  // Ends velocity jog mode without planning any further blocks.
+  void jog_velocity_stop();
+#endif
+
 #endif
@@ -111,11 +111,149 @@ ISR(LIMIT_INT_vect) //Limit pin change interrupt process.
     if (!(sys_rt_exec_alarm)) {
       mc_reset(); // Initiate system kill.
       system_set_exec_alarm(EXEC_ALARM_HARD_LIMIT); // Indicate hard limit critical event
+      #ifdef HOMING_VERIFY_CYCLE
+        sys_home_trusted = 0; // Axis has been pushed into a switch. Position can't be trusted.
+      #endif
     }
   }
 }
 
 
+#ifdef HOMING_VERIFY_CYCLE
+// Verify-home motion types. See limits_verify_motion().
+#define VERIFY_MOTION_APPROACH 0 // Motion must complete without tripping any cycle limit switch.
+#define VERIFY_MOTION_LOCATE   1 // Motion must trip every cycle limit switch before completing.
+#define VERIFY_MOTION_PULLOFF  2 // Motion must complete with all cycle limit switches released.
+
+// Executes one verify-home motion of the cycle_mask axes to target and checks that the limit
+// switches behave as predicted from the trusted machine position. During a locate motion, each axis
+// is locked out as its switch trips and the step position at the trip is stored in trip_steps.
+// Returns true if the motion completed as expected. Returns false otherwise, or upon a reset, where
+// the system abort is then set the same as a failed homing cycle.
+static uint8_t limits_verify_motion(float *target, plan_line_data_t *pl_data, uint8_t cycle_mask,
+                                    uint8_t motion, int32_t *trip_steps)
+{
+  uint8_t idx;
+  uint8_t limit_state = 0;
+  uint8_t axislock = 0;
+  for (idx=0; idx<N_AXIS; idx++) {
+    if (bit_istrue(cycle_mask,bit(idx))) { axislock |= get_step_pin_mask(idx); }
+  }
+
+  if (plan_buffer_line(target, pl_data) == PLAN_EMPTY_BLOCK) { // Already at target.
+    return(motion != VERIFY_MOTION_LOCATE);
+  }
+  sys.homing_axis_lock = axislock;
+  sys.step_control = STEP_CONTROL_EXECUTE_SYS_MOTION; // Set to execute homing motion and clear existing flags.
+  st_prep_buffer(); // Prep and fill segment buffer from newly planned block.
+  st_wake_up(); // Enable steppers
+  do {
+    if (motion != VERIFY_MOTION_PULLOFF) {
+      limit_state = limits_get_state() & cycle_mask;
+      if (limit_state) {
+        if (motion == VERIFY_MOTION_APPROACH) { break; } // Tripped early. Position is not as expected.
+        for (idx=0; idx<N_AXIS; idx++) {
+          if ((axislock & get_step_pin_mask(idx)) && (limit_state & bit(idx))) {
+            axislock &= ~(get_step_pin_mask(idx)); // Lock out axis and record its trip position.
+            trip_steps[idx] = sys_position[idx];
+          }
+        }
+        sys.homing_axis_lock = axislock;
+      }
+    }
+
+    st_prep_buffer(); // Check and prep segment buffer. NOTE: Should take no longer than 200us.
+
+    if (sys_rt_exec_state & (EXEC_RESET | EXEC_CYCLE_STOP)) {
+      if (sys_rt_exec_state & EXEC_RESET) {
+        system_set_exec_alarm(EXEC_ALARM_HOMING_FAIL_RESET);
+        mc_reset(); // Stop motors, if they are running.
+        protocol_execute_realtime();
+        return(false);
+      }
+      break; // Motion complete.
+    }
+  } while (STEP_MASK & axislock);
+
+  st_reset(); // Immediately force kill steppers and reset step segment buffer.
+  system_clear_exec_state_flag(EXEC_CYCLE_STOP);
+  delay_ms(settings.homing_debounce_delay); // Delay to allow transient dynamics to dissipate.
+
+  switch (motion) {
+    case VERIFY_MOTION_APPROACH: return(limit_state == 0);
+    case VERIFY_MOTION_LOCATE: return((STEP_MASK & axislock) == 0);
+    default: return((limits_get_state() & cycle_mask) == 0); // VERIFY_MOTION_PULLOFF
+  }
+}
+
+
+// Quickly verifies the home position of the cycle_mask axes from their trusted machine position.
+// Rapids to HOMING_VERIFY_DISTANCE short of the limit switches, locates them with a single pass at
+// the homing feed rate, and accepts the result when each switch trips within HOMING_VERIFY_TOLERANCE
+// of its expected position. Machine position is then re-zeroed on the switches and pulled off, the
+// same as the full homing cycle. Returns false if the home position could not be verified.
+static uint8_t limits_verify_home(uint8_t cycle_mask)
+{
+  plan_line_data_t plan_data;
+  plan_line_data_t *pl_data = &plan_data;
+  memset(pl_data,0,sizeof(plan_line_data_t));
+  pl_data->condition = (PL_COND_FLAG_SYSTEM_MOTION|PL_COND_FLAG_NO_FEED_OVERRIDE|PL_COND_FLAG_RAPID_MOTION);
+  #ifdef USE_LINE_NUMBERS
+    pl_data->line_number = HOMING_CYCLE_LINE_NUMBER;
+  #endif
+
+  float approach[N_AXIS], locate[N_AXIS], pulloff[N_AXIS];
+  int32_t home_steps[N_AXIS];
+  int32_t trip_steps[N_AXIS];
+  uint8_t n_active_axis = 0;
+  uint8_t idx;
+  system_convert_array_steps_to_mpos(approach,sys_position);
+  memcpy(locate,approach,sizeof(approach));
+  memcpy(pulloff,approach,sizeof(approach));
+  for (idx=0; idx<N_AXIS; idx++) {
+    if (bit_istrue(cycle_mask,bit(idx))) {
+      n_active_axis++;
+      // Limit switch location in machine position and the direction towards it.
+      // NOTE: settings.max_travel[] is stored as a negative value.
+      float home = 0.0;
+      float dir = 1.0;
+      if (bit_istrue(settings.homing_dir_mask,bit(idx))) {
+        home = settings.max_travel[idx];
+        dir = -1.0;
+      }
+      home_steps[idx] = lround(home*settings.steps_per_mm[idx]);
+      approach[idx] = home - dir*HOMING_VERIFY_DISTANCE;
+      locate[idx] = home + dir*HOMING_VERIFY_TOLERANCE;
+      pulloff[idx] = home - dir*settings.homing_pulloff;
+    }
+  }
+
+  // Rapid to just short of the limit switches. No switch should trip.
+  if (!limits_verify_motion(approach, pl_data, cycle_mask, VERIFY_MOTION_APPROACH, NULL)) { return(false); }
+
+  // Single locate pass. Every switch must trip within tolerance of its expected location.
+  pl_data->condition &= ~(PL_COND_FLAG_RAPID_MOTION);
+  pl_data->feed_rate = settings.homing_feed_rate*sqrt(n_active_axis);
+  if (!limits_verify_motion(locate, pl_data, cycle_mask, VERIFY_MOTION_LOCATE, trip_steps)) { return(false); }
+  for (idx=0; idx<N_AXIS; idx++) {
+    if (bit_istrue(cycle_mask,bit(idx))) {
+      if (labs(trip_steps[idx]-home_steps[idx]) > lround(HOMING_VERIFY_TOLERANCE*settings.steps_per_mm[idx])) {
+        return(false);
+      }
+      sys_position[idx] = home_steps[idx]; // Axis is stopped on its switch. Re-zero to it.
+    }
+  }
+
+  // Pull-off motion. Switches must release.
+  pl_data->feed_rate = settings.homing_seek_rate*sqrt(n_active_axis);
+  if (!limits_verify_motion(pulloff, pl_data, cycle_mask, VERIFY_MOTION_PULLOFF, NULL)) { return(false); }
+
+  sys.step_control = STEP_CONTROL_NORMAL_OP; // Return step control to normal operation.
+  return(true);
+}
+#endif
+
+
 // Home the specified cycle axes, set machine position, and perform a pull-off motion after
 // completing. Homing is a special motion case, which involves rapid uncontrolled stops to locate
 // the trigger point of the limit switches. The rapid stops are handled by a system level axis lock
@@ -128,6 +266,15 @@ void limits_go_home(uint8_t cycle_mask) //runs once for each part of the homing
    //For $HX: HOMING_CYCLE_X=0, $HY: HOMING_CYCLE_Y=1, $HZ: HOMING_CYCLE_Z=2
   if (sys.abort) { return; } // Block if system reset has been issued.
 
+  #ifdef HOMING_VERIFY_CYCLE
+    // Skip the full search and locate cycle, if the trusted home position can be quickly verified.
+    if ((sys_home_trusted & cycle_mask) == cycle_mask) {
+      if (limits_verify_home(cycle_mask)) { return; }
+      if (sys.abort) { return; } // Reset issued during verify.
+      sys_home_trusted &= ~(cycle_mask); // Not verified. Fall back to full homing cycle.
+    }
+  #endif
+
   // Initialize plan data struct for homing motion. Spindle is disabled.
   plan_line_data_t plan_data;
   plan_line_data_t *pl_data = &plan_data; //The address of plan_data is written to "*pl_data" 
@@ -283,6 +430,9 @@ void limits_go_home(uint8_t cycle_mask) //runs once for each part of the homing
     sys_position[idx] = set_axis_position;
     }
   }
+  #ifdef HOMING_VERIFY_CYCLE
+    sys_home_trusted |= cycle_mask; // Homed axes may be quickly verified next time.
+  #endif
   sys.step_control = STEP_CONTROL_NORMAL_OP; // Return step control to normal operation.
 }
 
@@ -333,6 +483,10 @@ int16_t limits_find_trip_delta_X1X2()
   #endif
   //Ready to plan motion
 
+  #ifdef HOMING_VERIFY_CYCLE
+    sys_home_trusted &= ~bit(X_AXIS); // X position is overwritten below. Force a full X homing cycle.
+  #endif
+
   //*******************************************************************************
 
   // move X away from limit switches to ensure X1 isn't already tripped
@@ -26,11 +26,17 @@
 system_t sys;
 int32_t sys_position[N_AXIS];      // Real-time machine (aka home) position vector in steps.
 int32_t sys_probe_position[N_AXIS]; // Last probe position in machine coordinates and steps.
+#ifdef HOMING_VERIFY_CYCLE
+  uint8_t sys_home_trusted; // Axes mask with a trusted position since their last homing cycle.
+#endif
 volatile uint8_t sys_probe_state;   // Probing state value.  Used to coordinate the probing cycle with stepper ISR.
 volatile uint8_t sys_rt_exec_state;   // Global realtime executor bitflag variable for state management. See EXEC bitmasks.
 volatile uint8_t sys_rt_exec_alarm;   // Global realtime executor bitflag variable for setting various alarms.
 volatile uint8_t sys_rt_exec_motion_override; // Global realtime executor bitflag variable for motion-based overrides.
 volatile uint8_t sys_rt_exec_accessory_override; // Global realtime executor bitflag variable for spindle overrides.
+#ifdef USE_SYSTEM_TICK
+  volatile uint8_t sys_tick; // Free-running watchdog tick counter.
+#endif
 
 int main(void)
 {
@@ -40,6 +46,9 @@ int main(void)
   stepper_init();  // Configure stepper pins and interrupt timers
 
   memset(sys_position,0,sizeof(sys_position)); // Clear machine position.
+  #ifdef USE_SYSTEM_TICK
+    system_tick_init();
+  #endif
   sei(); // Enable interrupts
 
   // Initialize system state.
@@ -66,6 +75,7 @@ int main(void)
     sys.r_override = DEFAULT_RAPID_OVERRIDE; // Set to 100%
     sys.spindle_speed_ovr = DEFAULT_SPINDLE_SPEED_OVERRIDE; // Set to 100%
 		memset(sys_probe_position,0,sizeof(sys_probe_position)); // Clear probe position.
+    probe_update_position_offset(false);
     sys_probe_state = 0;
     sys_rt_exec_state = 0;
     sys_rt_exec_alarm = 0;
@@ -73,6 +83,12 @@ int main(void)
     sys_rt_exec_accessory_override = 0;
 
     // Reset Grbl primary systems.
+    #ifdef ENABLE_EEPROM_IMAGE_COMMANDS
+      if (settings_image_stale) {
+        settings_init(); // Reload settings, journal and coordinate data rewritten by '$EW'.
+        settings_image_stale = false;
+      }
+    #endif
     serial_reset_read_buffer(); // Clear serial read buffer
     gc_init(); // Set g-code parser to default state
     spindle_init();
@@ -80,6 +96,9 @@ int main(void)
     probe_init();
     plan_reset(); // Clear block buffer and planner variables
     st_reset(); // Clear stepper subsystem variables.
+    #ifdef ENABLE_VELOCITY_JOG
+      jog_velocity_stop();
+    #endif
     st_set_power_level('0'); //turn steppers off (haven't homed yet)
 
     // Sync cleared gcode and planner positions to current system position.
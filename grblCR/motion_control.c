@@ -20,6 +20,175 @@
 */
 #include "grbl.h"
 
+// Heightmap grid line tolerance in grid point units. Prevents zero-length pieces when a line
+// motion starts on a grid line.
+#ifndef HEIGHTMAP_SPLIT_EPSILON
+  #define HEIGHTMAP_SPLIT_EPSILON 1E-4
+#endif
+
+#ifdef ENABLE_HEIGHTMAP
+  // Evaluates true, if a heightmap is loaded and the motion is to be compensated by it.
+  #define mc_heightmap_compensates(pl_data) \
+    (heightmap.n_points[X_AXIS] && !((pl_data)->condition & PL_COND_FLAG_NO_HEIGHTMAP))
+#endif
+
+
+// Waits for room in the planner buffer and queues the line motion. Called by mc_line() only.
+static void mc_buffer_line(float *target, plan_line_data_t *pl_data)
+{
+  // If the buffer is full: good! That means we are well ahead of the robot.
+  // Remain in this loop until there is room in the buffer.
+  do {
+    protocol_execute_realtime(); // Check for any run-time commands
+    if (sys.abort) { return; } // Bail, if system abort.
+    if ( plan_check_full_buffer() ) { protocol_auto_cycle_start(); } // Auto-cycle start when buffer is full.
+    else { break; }
+  } while (1);
+
+  // Plan and queue motion into planner buffer
+  plan_buffer_line(target, pl_data);
+}
+
+
+#ifdef ENABLE_HEIGHTMAP
+// Splits a line motion at every heightmap grid line it crosses and offsets the Z target of each
+// piece by the interpolated height. The uncompensated start height is recovered from the planner
+// position, so consecutive compensated motions chain correctly.
+// NOTE: The g-code parser position remains uncompensated. Positions synced from the machine
+// position, such as after a probe or jog cancel, will include the height offset.
+static void mc_line_heightmap(float *target, plan_line_data_t *pl_data)
+{
+  float start[N_AXIS];
+  float segment[N_AXIS];
+  plan_get_planner_mpos(start);
+  start[Z_AXIS] -= probe_get_heightmap_offset(start);
+
+  float inverse_time_rate = pl_data->feed_rate;
+  float t = 0.0; // Parametric position along motion. 0 = start, 1 = target.
+  float t_next;
+  uint8_t idx;
+  do {
+    // Find nearest grid line crossing ahead of t along X and Y.
+    t_next = 1.0;
+    for (idx=0; idx<2; idx++) {
+      float delta = target[idx]-start[idx];
+      if (delta == 0.0) { continue; }
+      float spacing = heightmap.spacing[idx];
+      float pos = (start[idx]+t*delta-heightmap.origin[idx])/spacing; // In grid point units.
+      float line;
+      if ((delta > 0.0) == (spacing > 0.0)) { // Moving towards increasing grid index.
+        line = floor(pos+HEIGHTMAP_SPLIT_EPSILON)+1.0;
+        if (line < 0.0) { line = 0.0; }
+        if (line > heightmap.n_points[idx]-1) { continue; } // No more grid lines ahead.
+      } else {
+        line = ceil(pos-HEIGHTMAP_SPLIT_EPSILON)-1.0;
+        if (line > heightmap.n_points[idx]-1) { line = heightmap.n_points[idx]-1; }
+        if (line < 0.0) { continue; }
+      }
+      float t_line = (heightmap.origin[idx]+line*spacing-start[idx])/delta;
+      if (t_line < t_next) { t_next = t_line; }
+    }
+
+    if (t_next >= 1.0) {
+      t_next = 1.0;
+      memcpy(segment,target,sizeof(segment));
+    } else {
+      for (idx=0; idx<N_AXIS; idx++) { segment[idx] = start[idx]+t_next*(target[idx]-start[idx]); }
+    }
+    segment[Z_AXIS] += probe_get_heightmap_offset(segment);
+
+    // The compensated target is soft limit checked by mc_line(). Check the pieces ending on grid
+    // lines too, where the compensated height of the motion may peak.
+    if ((t_next < 1.0) && bit_istrue(settings.flags,BITFLAG_SOFT_LIMIT_ENABLE) && (sys.state != STATE_JOG)) {
+      limits_soft_check(segment);
+      if (sys.abort) { break; }
+    }
+
+    // Inverse time feed rates scale with the fraction of the motion in this piece.
+    if (pl_data->condition & PL_COND_FLAG_INVERSE_TIME) { pl_data->feed_rate = inverse_time_rate/(t_next-t); }
+    mc_buffer_line(segment, pl_data);
+    if (sys.abort) { break; }
+    t = t_next;
+  } while (t < 1.0);
+  pl_data->feed_rate = inverse_time_rate;
+}
+#endif
+
+
+// Plans a line motion into the planner buffer, compensated by the heightmap when one is loaded.
+static void mc_plan_line(float *target, plan_line_data_t *pl_data)
+{
+  #ifdef ENABLE_HEIGHTMAP
+    if (mc_heightmap_compensates(pl_data)) { // Heightmap loaded. Compensate Z.
+      mc_line_heightmap(target, pl_data);
+      return;
+    }
+  #endif
+
+  mc_buffer_line(target, pl_data);
+}
+
+
+#ifdef ENABLE_DOGLEG_RAPIDS
+// Splits a rapid motion into non-coordinated legs, in which every moving axis runs at its own maximum
+// rate, instead of all axes slowing to trace a straight line. A Z retract is executed first and a Z
+// plunge last, so XY travel always happens at the higher of the start and target heights. The XY
+// leg moves both axes at their maximum rates until the faster finishing axis arrives, and then moves
+// the remaining axis alone. All legs stay within the box spanned by the start and target, so the
+// soft limit check of the target covers them.
+static void mc_line_dogleg(float *target, plan_line_data_t *pl_data)
+{
+  float position[N_AXIS];
+  plan_get_planner_mpos(position);
+  #ifdef ENABLE_HEIGHTMAP
+    if (heightmap.n_points[X_AXIS]) { position[Z_AXIS] -= probe_get_heightmap_offset(position); }
+  #endif
+
+  if (target[Z_AXIS] > position[Z_AXIS]) { // Retract first.
+    position[Z_AXIS] = target[Z_AXIS];
+    mc_plan_line(position, pl_data);
+    if (sys.abort) { return; }
+  }
+
+  // Leg timing uses the max rates the planner applies to this motion.
+  float max_rate_x = settings.max_rate[X_AXIS];
+  float max_rate_y = settings.max_rate[Y_AXIS];
+  #ifdef ENABLE_MOTION_PROFILES
+    max_rate_x = plan_get_profile_max_rate(pl_data->motion_profile, X_AXIS);
+    max_rate_y = plan_get_profile_max_rate(pl_data->motion_profile, Y_AXIS);
+  #endif
+  float delta_x = target[X_AXIS]-position[X_AXIS];
+  float delta_y = target[Y_AXIS]-position[Y_AXIS];
+  float time_x = fabs(delta_x)/max_rate_x;
+  float time_y = fabs(delta_y)/max_rate_y;
+  if (time_x < time_y) {
+    if (time_x > 0.0) { // Diagonal until X arrives.
+      position[X_AXIS] = target[X_AXIS];
+      if (delta_y > 0.0) { position[Y_AXIS] += max_rate_y*time_x; }
+      else { position[Y_AXIS] -= max_rate_y*time_x; }
+      mc_plan_line(position, pl_data);
+      if (sys.abort) { return; }
+    }
+  } else if (time_y < time_x) {
+    if (time_y > 0.0) { // Diagonal until Y arrives.
+      position[Y_AXIS] = target[Y_AXIS];
+      if (delta_x > 0.0) { position[X_AXIS] += max_rate_x*time_y; }
+      else { position[X_AXIS] -= max_rate_x*time_y; }
+      mc_plan_line(position, pl_data);
+      if (sys.abort) { return; }
+    }
+  }
+
+  if (target[Z_AXIS] < position[Z_AXIS]) { // Plunge last.
+    position[X_AXIS] = target[X_AXIS];
+    position[Y_AXIS] = target[Y_AXIS];
+    mc_plan_line(position, pl_data);
+    if (sys.abort) { return; }
+  }
+  mc_plan_line(target, pl_data);
+}
+#endif
+
 
 // Execute linear motion in absolute millimeter coordinates. Feed rate given in millimeters/second
 // unless invert_feed_rate is true. Then the feed_rate means that the motion should be completed in
@@ -34,7 +203,17 @@ void mc_line(float *target, plan_line_data_t *pl_data)
   // from everywhere in Grbl.
   if (bit_istrue(settings.flags,BITFLAG_SOFT_LIMIT_ENABLE)) {
     // NOTE: Block jog state. Jogging is a special case and soft limits are handled independently.
-    if (sys.state != STATE_JOG) { limits_soft_check(target); }
+    if (sys.state != STATE_JOG) {
+      #ifdef ENABLE_HEIGHTMAP
+        if (mc_heightmap_compensates(pl_data)) { // Check the compensated target.
+          float compensated[N_AXIS];
+          memcpy(compensated, target, sizeof(compensated));
+          compensated[Z_AXIS] += probe_get_heightmap_offset(compensated);
+          limits_soft_check(compensated);
+        } else
+      #endif
+      limits_soft_check(target);
+    }
   }
 
   // If in check gcode mode, prevent motion by blocking planner. Soft limits still work.
@@ -54,17 +233,14 @@ void mc_line(float *target, plan_line_data_t *pl_data)
   // doesn't update the machine position values. Since the position values used by the g-code
   // parser and planner are separate from the system machine positions, this is doable.
 
-  // If the buffer is full: good! That means we are well ahead of the robot.
-  // Remain in this loop until there is room in the buffer.
-  do {
-    protocol_execute_realtime(); // Check for any run-time commands
-    if (sys.abort) { return; } // Bail, if system abort.
-    if ( plan_check_full_buffer() ) { protocol_auto_cycle_start(); } // Auto-cycle start when buffer is full.
-    else { break; }
-  } while (1);
+  #ifdef ENABLE_DOGLEG_RAPIDS
+    if (pl_data->condition & PL_COND_FLAG_RAPID_MOTION) {
+      mc_line_dogleg(target, pl_data);
+      return;
+    }
+  #endif
 
-  // Plan and queue motion into planner buffer
-  plan_buffer_line(target, pl_data);
+  mc_plan_line(target, pl_data);
 }
 
 
@@ -93,6 +269,45 @@ void mc_arc(float *target, plan_line_data_t *pl_data, float *position, float *of
     if (angular_travel <= ARC_ANGULAR_TRAVEL_EPSILON) { angular_travel += 2*M_PI; }
   }
 
+  #ifdef ENABLE_NATIVE_ARCS
+  // Plan the arc as a single block traced by the stepper module, unless the heightmap needs chords.
+  #ifdef ENABLE_HEIGHTMAP
+  if (!heightmap.n_points[X_AXIS])
+  #endif
+  {
+    // The arc may reach past its end points. Soft limit check the axis extremes of the circle swept
+    // by the arc. The target is checked by mc_line().
+    if (bit_istrue(settings.flags,BITFLAG_SOFT_LIMIT_ENABLE) && (sys.state != STATE_JOG)) {
+      float extreme[N_AXIS];
+      memcpy(extreme, target, sizeof(extreme));
+      float start_angle = atan2(r_axis1, r_axis0);
+      uint8_t quadrant;
+      for (quadrant=0; quadrant<4; quadrant++) {
+        float sweep = quadrant*(0.5*M_PI) - start_angle; // CCW angle from start to extreme point.
+        if (sweep < 0.0) { sweep += 2*M_PI; }
+        if (sweep >= 2*M_PI) { sweep -= 2*M_PI; }
+        if (is_clockwise_arc) { sweep = 2*M_PI - sweep; }
+        if (sweep < fabs(angular_travel)) {
+          extreme[axis_0] = center_axis0;
+          extreme[axis_1] = center_axis1;
+          if (quadrant & 0x01) { extreme[axis_1] += (quadrant == 1) ? radius : -radius; }
+          else { extreme[axis_0] += (quadrant == 0) ? radius : -radius; }
+          limits_soft_check(extreme);
+          if (sys.abort) { return; }
+        }
+      }
+    }
+
+    pl_data->arc_radius[0] = r_axis0;
+    pl_data->arc_radius[1] = r_axis1;
+    pl_data->arc_travel = angular_travel;
+    pl_data->arc_axes = ARC_AXES(axis_0, axis_1, axis_linear);
+    mc_line(target, pl_data);
+    pl_data->arc_travel = 0.0; // Following motions of this block are lines.
+    return;
+  }
+  #endif
+
   // NOTE: Segment end points are on the arc, which can lead to the arc diameter being smaller by up to
   // (2x) settings.arc_tolerance. For 99% of users, this is just fine. If a different arc segment fit
   // is desired, i.e. least-squares, midpoint on arc, just change the mm_per_arc_segment calculation.
@@ -182,14 +397,159 @@ void mc_arc(float *target, plan_line_data_t *pl_data, float *position, float *of
 }
 
 
+#ifdef ENABLE_SPLINES
+// Execute a cubic Bezier spline in the XY plane. position == current xyz, target == target xyz,
+// first == first control point offset from position, second == second control point offset from target.
+// Z moves linearly along the spline, like the linear axis of a helical arc.
+// The spline is approximated by linear segments of equal parameter step. The chordal error of a segment
+// is bounded by 1/8 of the largest second derivative times the step squared, so the segment count is
+// set to keep it within settings.arc_tolerance. The segment points are computed by forward differencing,
+// which only needs three additions per axis and segment, much like the mc_arc() rotation recurrence.
+void mc_spline(float *target, plan_line_data_t *pl_data, float *position, float *first, float *second)
+{
+  // Power basis coefficients of B(t) = a*t^3 + b*t^2 + c*t, relative to the start point, and the
+  // largest second difference of the control polygon, which bounds the curvature of the spline.
+  float a[2], b[2], c[2], v[2];
+  uint8_t idx;
+  for (idx=X_AXIS; idx<=Y_AXIS; idx++) {
+    float p3 = target[idx]-position[idx];
+    float p2 = p3+second[idx];
+    a[idx] = 3.0*(first[idx]-p2)+p3;
+    b[idx] = 3.0*(p2-2.0*first[idx]);
+    c[idx] = 3.0*first[idx];
+    v[idx] = p2-2.0*first[idx]; // P0-2*P1+P2
+  }
+  float bend = hypot_f(v[X_AXIS],v[Y_AXIS]);
+  for (idx=X_AXIS; idx<=Y_AXIS; idx++) { v[idx] += a[idx]; } // P1-2*P2+P3
+  bend = max(bend,hypot_f(v[X_AXIS],v[Y_AXIS]));
+
+  // Max chordal error = (1/8)*(6*bend)*(1/segments)^2 <= arc_tolerance
+  uint16_t segments = ceil(sqrt(0.75*bend/settings.arc_tolerance));
+
+  if (segments > 1) {
+    // Multiply inverse feed_rate to compensate for the fact that this movement is approximated
+    // by a number of discrete segments. The inverse feed_rate should be correct for the sum of
+    // all segments.
+    if (pl_data->condition & PL_COND_FLAG_INVERSE_TIME) {
+      pl_data->feed_rate *= segments;
+      bit_false(pl_data->condition,PL_COND_FLAG_INVERSE_TIME); // Force as feed absolute mode over spline segments.
+    }
+
+    float h = 1.0/segments;
+    float linear_per_segment = (target[Z_AXIS] - position[Z_AXIS])*h;
+    float start[2] = { position[X_AXIS], position[Y_AXIS] };
+
+    // Forward differences of B(t) at t = 0 for the parameter step h. The third difference is constant.
+    // Single precision additions accumulate some error over many segments, so, as with arcs, the exact
+    // point is recomputed every N_ARC_CORRECTION segments.
+    float point[2], delta1[2], delta2[2], delta3[2];
+    for (idx=X_AXIS; idx<=Y_AXIS; idx++) {
+      point[idx] = 0.0;
+      delta3[idx] = 6.0*a[idx]*h*h*h;
+      delta2[idx] = delta3[idx] + 2.0*b[idx]*h*h;
+      delta1[idx] = ((a[idx]*h + b[idx])*h + c[idx])*h;
+    }
+
+    uint16_t i;
+    uint8_t count = 0;
+    for (i = 1; i<segments; i++) { // Increment (segments-1).
+      float t = i*h;
+      for (idx=X_AXIS; idx<=Y_AXIS; idx++) {
+        if (count < N_ARC_CORRECTION) { point[idx] += delta1[idx]; }
+        else { point[idx] = ((a[idx]*t + b[idx])*t + c[idx])*t; } // Spline correction. Horner's method.
+        delta1[idx] += delta2[idx];
+        delta2[idx] += delta3[idx];
+        position[idx] = start[idx] + point[idx];
+      }
+      if (count < N_ARC_CORRECTION) { count++; }
+      else { count = 0; }
+      position[Z_AXIS] += linear_per_segment;
+
+      mc_line(position, pl_data);
+
+      // Bail mid-spline on system abort. Runtime command check already performed by mc_line.
+      if (sys.abort) { return; }
+    }
+  }
+  // Ensure last segment arrives at target location.
+  mc_line(target, pl_data);
+}
+#endif
+
+
 // Execute dwell in seconds.
-void mc_dwell(float seconds)
+// NOTE: If enabled, the dwell is queued in the planner buffer with the spindle state of pl_data.
+void mc_dwell(float seconds, plan_line_data_t *pl_data)
 {
   if (sys.state == STATE_CHECK_MODE) { return; }
-  protocol_buffer_synchronize();
-  delay_sec(seconds, DELAY_MODE_DWELL);
+  #ifdef PLAN_SPINDLE_AND_DWELL_EVENTS
+    // Remain in this loop until there is room in the buffer.
+    do {
+      protocol_execute_realtime(); // Check for any run-time commands
+      if (sys.abort) { return; } // Bail, if system abort.
+      if ( plan_check_full_buffer() ) { protocol_auto_cycle_start(); } // Auto-cycle start when buffer is full.
+      else { break; }
+    } while (1);
+    plan_buffer_dwell(seconds, pl_data);
+  #else
+    protocol_buffer_synchronize();
+    delay_sec(seconds, DELAY_MODE_DWELL);
+  #endif
 }
 
+
+#ifdef ENABLE_CANNED_CYCLES
+// Execute a drilling canned cycle. The tool rises to the R plane if below it, rapids over the hole and
+// down to the R plane, drills to the bottom, and rapids out to the retract height. G81 drills in one
+// feed move and G82 dwells at the bottom. G83 drills in pecks and rapids back to the R plane after each
+// one to clear the chips, while G73 only backs off CANNED_CYCLE_PECK_CLEARANCE to break the chip. The
+// next peck rapids back to CANNED_CYCLE_PECK_CLEARANCE above the previous bottom before feeding.
+// NOTE: Every move is a normal planner line, so the cycle is fed to the planner as buffer slots free up
+// and is subject to the same soft limit checks, overrides, feed holds, and check mode as any g-code line.
+void mc_canned_cycle(float *target, plan_line_data_t *pl_data, float *position, uint8_t cycle,
+  float r_level, float retract_level, float peck, float dwell)
+{
+  plan_line_data_t rapid_data;
+  memcpy(&rapid_data,pl_data,sizeof(plan_line_data_t));
+  rapid_data.condition |= PL_COND_FLAG_RAPID_MOTION;
+
+  float point[N_AXIS];
+  memcpy(point,position,sizeof(point));
+  if (point[Z_AXIS] < r_level) { // Rise to the R plane before moving over the hole.
+    point[Z_AXIS] = r_level;
+    mc_line(point,&rapid_data);
+  }
+  point[X_AXIS] = target[X_AXIS];
+  point[Y_AXIS] = target[Y_AXIS];
+  mc_line(point,&rapid_data);
+  point[Z_AXIS] = r_level;
+  mc_line(point,&rapid_data);
+
+  if ((cycle == MOTION_MODE_DRILL) || (cycle == MOTION_MODE_DRILL_DWELL)) {
+    mc_line(target,pl_data);
+    if (cycle == MOTION_MODE_DRILL_DWELL) { mc_dwell(dwell,pl_data); }
+  } else { // G73 and G83
+    float bottom = r_level;
+    for (;;) {
+      bottom -= peck;
+      if (bottom < target[Z_AXIS]) { bottom = target[Z_AXIS]; }
+      point[Z_AXIS] = bottom;
+      mc_line(point,pl_data);
+      if ((bottom == target[Z_AXIS]) || sys.abort) { break; }
+      if (cycle == MOTION_MODE_DRILL_PECK) { // Clear the chips out of the hole.
+        point[Z_AXIS] = r_level;
+        mc_line(point,&rapid_data);
+      }
+      point[Z_AXIS] = min(bottom+CANNED_CYCLE_PECK_CLEARANCE,r_level);
+      mc_line(point,&rapid_data);
+    }
+  }
+
+  point[Z_AXIS] = retract_level;
+  mc_line(point,&rapid_data);
+}
+#endif
+
 // '$L' Levels X axis using calibration data (dual steppers).  Requires dual X limits.
 void mc_autolevel_X()
 {
@@ -199,7 +559,7 @@ void mc_autolevel_X()
   int16_t delta_as_found = limits_find_trip_delta_X1X2(); //find difference between limit switches (X)
   int16_t delta_calibrated = settings_read_calibration_data(ADDR_CAL_DATA_XDELTA); //read stored difference from EEPROM
   
-  float squaring_mm2move = ( (float)(delta_calibrated - delta_as_found) ) / settings.steps_per_mm[X_AXIS];
+  float squaring_mm2move = ( (float)(delta_calibrated - delta_as_found) ) * settings_derived.mm_per_step[X_AXIS];
   //printPgmString(PSTR("[adj "));
   serial_write('[');
   printFloat_CoordValue(squaring_mm2move);
@@ -233,6 +593,9 @@ void mc_autolevel_X()
     // move X away from limit switches to prevent tripping during squaring routine
     system_convert_array_steps_to_mpos(target,sys_position); //convert steps to mm on all three axes
     sys_position[X_AXIS] = 0;
+    #ifdef HOMING_VERIFY_CYCLE
+      sys_home_trusted &= ~bit(X_AXIS); // Position overwritten. Force a full X homing cycle.
+    #endif
     target[X_AXIS] = squaring_mm2move; //The calibrated offset we're trying to restore
     sys.homing_axis_lock = get_step_pin_mask(X_AXIS); //enable X axis motion
     pl_data->feed_rate = settings.homing_feed_rate; //move slowly
@@ -330,17 +693,10 @@ void mc_homing_cycle(uint8_t cycle_mask) // cycle_mask is: HOMING_CYCLE_ALL, HOM
 }
 
 
-// Perform tool length probe cycle. Requires probe switch.
-// NOTE: Upon probe failure, the program will be stopped and placed into ALARM state.
-uint8_t mc_probe_cycle(float *target, plan_line_data_t *pl_data, uint8_t parser_flags)
+// Executes a single probing motion to target and records the probe position. Called by mc_probe_cycle()
+// and mc_probe_heightmap() only, after the planner buffer is empty. Returns GC_PROBE_FOUND or GC_PROBE_FAIL_END upon completion.
+static uint8_t mc_probe_move(float *target, plan_line_data_t *pl_data, uint8_t parser_flags)
 {
-  // TODO: Need to update this cycle so it obeys a non-auto cycle start.
-  if (sys.state == STATE_CHECK_MODE) { return(GC_PROBE_CHECK_MODE); }
-
-  // Finish all queued commands and empty planner buffer before starting probe cycle.
-  protocol_buffer_synchronize();
-  if (sys.abort) { return(GC_PROBE_ABORT); } // Return if system reset has been issued.
-
   // Initialize probing control variables
   uint8_t is_probe_away = bit_istrue(parser_flags,GC_PARSER_PROBE_IS_AWAY);
   uint8_t is_no_error = bit_istrue(parser_flags,GC_PARSER_PROBE_IS_NO_ERROR);
@@ -377,10 +733,14 @@ uint8_t mc_probe_cycle(float *target, plan_line_data_t *pl_data, uint8_t parser_
 
   // Set state variables and error out, if the probe failed and cycle with error is enabled.
   if (sys_probe_state == PROBE_ACTIVE) {
-    if (is_no_error) { memcpy(sys_probe_position, sys_position, sizeof(sys_position)); }
+    if (is_no_error) {
+      memcpy(sys_probe_position, sys_position, sizeof(sys_position));
+      probe_update_position_offset(false);
+    }
     else { system_set_exec_alarm(EXEC_ALARM_PROBE_FAIL_CONTACT); }
   } else {
     sys.probe_succeeded = true; // Indicate to system the probing cycle completed successfully.
+    probe_update_position_offset(true);
   }
   sys_probe_state = PROBE_OFF; // Ensure probe state monitor is disabled.
   probe_configure_invert_mask(false); // Re-initialize invert mask.
@@ -391,14 +751,145 @@ uint8_t mc_probe_cycle(float *target, plan_line_data_t *pl_data, uint8_t parser_
   plan_reset(); // Reset planner buffer. Zero planner positions. Ensure probing motion is cleared.
   plan_sync_position(); // Sync planner position to current machine position.
 
+  if (sys.probe_succeeded) { return(GC_PROBE_FOUND); } // Successful probe cycle.
+  else { return(GC_PROBE_FAIL_END); } // Failed to trigger probe within travel. With or without error.
+}
+
+
+// Perform tool length probe cycle. Requires probe switch.
+// If locate_rate is non-zero, performs a two-speed probe cycle. After the probe trips at the
+// programmed feed rate, the tool retracts from the trip position by the retract distance and
+// probes the same target again at the locate rate. Only the final probe position is reported.
+// NOTE: Upon probe failure, the program will be stopped and placed into ALARM state.
+uint8_t mc_probe_cycle(float *target, plan_line_data_t *pl_data, uint8_t parser_flags, float locate_rate, float retract)
+{
+  // TODO: Need to update this cycle so it obeys a non-auto cycle start.
+  if (sys.state == STATE_CHECK_MODE) { return(GC_PROBE_CHECK_MODE); }
+
+  // Finish all queued commands and empty planner buffer before starting probe cycle.
+  protocol_buffer_synchronize();
+  if (sys.abort) { return(GC_PROBE_ABORT); } // Return if system reset has been issued.
+
+  #ifdef ENABLE_HEIGHTMAP
+    // Probe and retract motions measure the work. They are not compensated.
+    pl_data->condition |= PL_COND_FLAG_NO_HEIGHTMAP;
+  #endif
+  #ifdef ENABLE_MOTION_PROFILES
+    pl_data->motion_profile = 0; // Probe with the '$' settings, regardless of the active profile.
+  #endif
+
+  #ifdef ENABLE_TWO_SPEED_PROBE
+    float position[N_AXIS];
+    system_convert_array_steps_to_mpos(position,sys_position); // Probe start position
+  #endif
+
+  uint8_t probe_status = mc_probe_move(target, pl_data, parser_flags);
+
+  #ifdef ENABLE_TWO_SPEED_PROBE
+    if ((locate_rate > 0.0) && (probe_status == GC_PROBE_FOUND)) {
+      // Retract from the trip position, opposite the probing direction.
+      float trip_position[N_AXIS];
+      float distance = 0.0;
+      uint8_t idx;
+      probe_get_mpos(trip_position);
+      for (idx=0; idx<N_AXIS; idx++) {
+        position[idx] = target[idx]-position[idx]; // Probing direction vector
+        distance += position[idx]*position[idx];
+      }
+      distance = retract/sqrt(distance);
+      for (idx=0; idx<N_AXIS; idx++) { position[idx] = trip_position[idx]-distance*position[idx]; }
+      mc_line(position, pl_data);
+      protocol_buffer_synchronize(); // Auto cycle-starts and waits for retract to complete.
+      if (sys.abort) { return(GC_PROBE_ABORT); }
+
+      // Locate the probe again at the slower locate feed rate.
+      pl_data->feed_rate = locate_rate;
+      probe_status = mc_probe_move(target, pl_data, parser_flags);
+    }
+  #endif
+
   #ifdef MESSAGE_PROBE_COORDINATES
     // All done! Output the probe position as message.
-    report_probe_parameters();
+    if (probe_status != GC_PROBE_ABORT) { report_probe_parameters(); }
   #endif
 
-  if (sys.probe_succeeded) { return(GC_PROBE_FOUND); } // Successful probe cycle.
-  else { return(GC_PROBE_FAIL_END); } // Failed to trigger probe within travel. With or without error.
+  return(probe_status);
+}
+
+#ifdef ENABLE_HEIGHTMAP
+// Probes an n_points[X] by n_points[Y] heightmap grid of the given XY size, starting from the current
+// position. Each grid point is approached at the current (clearance) height, probed downward by up to
+// depth at feed_rate, and retracted to the clearance height. Heights are stored in heightmap relative to
+// the first grid point. Compensation is disabled while probing and enabled only upon success.
+// NOTE: Uses mc_probe_move(), which issues the probe fail alarms, but doesn't report each probe
+// position like mc_probe_cycle(). Requires IDLE state.
+uint8_t mc_probe_heightmap(float *size, uint8_t *n_points, float depth, float feed_rate)
+{
+  memset(&heightmap, 0, sizeof(heightmap_t)); // Disable compensation while probing.
+  protocol_buffer_synchronize();
+  if (sys.abort) { return(STATUS_OK); }
+
+  float target[N_AXIS], probe_position[N_AXIS];
+  system_convert_array_steps_to_mpos(target,sys_position);
+  plan_sync_position(); // Ensure planner starts from the current machine position.
+  float clearance = target[Z_AXIS];
+  float origin[2], spacing[2];
+  uint8_t idx;
+  for (idx=0; idx<2; idx++) {
+    origin[idx] = target[idx];
+    spacing[idx] = size[idx]/(n_points[idx]-1);
+  }
+
+  int16_t z[HEIGHTMAP_MAX_POINTS];
+  float z_first = 0.0;
+  plan_line_data_t plan_data;
+  plan_line_data_t *pl_data = &plan_data;
+  uint8_t i, j;
+  for (j=0; j<n_points[Y_AXIS]; j++) {
+    for (i=0; i<n_points[X_AXIS]; i++) {
+      uint8_t col = (j & 1) ? (n_points[X_AXIS]-1-i) : i; // Serpentine path to minimize travel.
+
+      // Rapid to grid point at clearance height.
+      memset(pl_data,0,sizeof(plan_line_data_t));
+      pl_data->condition = PL_COND_FLAG_RAPID_MOTION;
+      target[X_AXIS] = origin[X_AXIS]+col*spacing[X_AXIS];
+      target[Y_AXIS] = origin[Y_AXIS]+j*spacing[Y_AXIS];
+      target[Z_AXIS] = clearance;
+      mc_line(target, pl_data);
+
+      // Probe down. Failure to make contact issues an alarm.
+      pl_data->condition = PL_COND_FLAG_NO_FEED_OVERRIDE;
+      pl_data->feed_rate = feed_rate;
+      target[Z_AXIS] = clearance-depth;
+      protocol_buffer_synchronize(); // Probe starts from an empty planner buffer.
+      if (sys.abort) { return(STATUS_OK); }
+      if (mc_probe_move(target, pl_data, 0) != GC_PROBE_FOUND) { return(STATUS_OK); } // Alarm or abort set.
+
+      probe_get_mpos(probe_position);
+      if ((i|j) == 0) { z_first = probe_position[Z_AXIS]; }
+      z[j*n_points[X_AXIS]+col] = lround(1000.0*(probe_position[Z_AXIS]-z_first));
+
+      // Retract to clearance height.
+      memset(pl_data,0,sizeof(plan_line_data_t));
+      pl_data->condition = PL_COND_FLAG_RAPID_MOTION;
+      target[Z_AXIS] = clearance;
+      mc_line(target, pl_data);
+    }
+  }
+  protocol_buffer_synchronize();
+  if (sys.abort) { return(STATUS_OK); }
+  gc_sync_position();
+
+  // Grid probed successfully. Load heightmap and enable compensation.
+  memcpy(heightmap.z,z,sizeof(z));
+  memcpy(heightmap.origin,origin,sizeof(origin));
+  memcpy(heightmap.spacing,spacing,sizeof(spacing));
+  heightmap.n_points[Y_AXIS] = n_points[Y_AXIS];
+  heightmap.n_points[X_AXIS] = n_points[X_AXIS]; // Set last. Enables compensation.
+  return(STATUS_OK);
 }
+#endif
+
 
 // Method to ready the system to reset by setting the realtime reset command and killing any
 // active processes in the system. This also checks if a system reset is issued while Grbl
@@ -425,6 +916,9 @@ void mc_reset()
       } else { system_set_exec_alarm(EXEC_ALARM_ABORT_CYCLE); }
 
       st_go_idle(); // Clean up steppers. Position has likely been lost.
+      #ifdef HOMING_VERIFY_CYCLE
+        sys_home_trusted = 0; // Force a full homing cycle next time.
+      #endif
       st_set_power_level('0'); //turn steppers completely off
     }
   }
@@ -44,8 +44,23 @@ void mc_line(float *target, plan_line_data_t *pl_data);
 void mc_arc(float *target, plan_line_data_t *pl_data, float *position, float *offset, float radius,
   uint8_t axis_0, uint8_t axis_1, uint8_t axis_linear, uint8_t is_clockwise_arc);
 
+#ifdef ENABLE_SPLINES
+  // Execute a G5 cubic Bezier spline in the XY plane. position == current xyz, target == target xyz,
+  // first == first control point offset from position, second == second control point offset from
+  // target. Segmented within the arc tolerance. G5.1 quadratic splines are passed as cubic ones.
+  void mc_spline(float *target, plan_line_data_t *pl_data, float *position, float *first, float *second);
+#endif
+
 // Dwell for a specific number of seconds
-void mc_dwell(float seconds);
+void mc_dwell(float seconds, plan_line_data_t *pl_data);
+
+#ifdef ENABLE_CANNED_CYCLES
+  // Execute a G73/G81/G82/G83 drilling canned cycle at the XY of target from position. r_level is the
+  // R plane, target[Z_AXIS] the hole bottom, and retract_level the final height, in machine coordinates.
+  // peck is the G73/G83 peck depth and dwell the G82 dwell time in seconds.
+  void mc_canned_cycle(float *target, plan_line_data_t *pl_data, float *position, uint8_t cycle,
+    float r_level, float retract_level, float peck, float dwell);
+#endif
 
 // Perform mill table level uses stored calibration data.  Requires dual X limits.
 void mc_autolevel_X();
@@ -57,7 +72,12 @@ void mc_X_is_level();
 void mc_homing_cycle(uint8_t cycle_mask);
 
 // Perform tool length probe cycle. Requires probe switch.
-uint8_t mc_probe_cycle(float *target, plan_line_data_t *pl_data, uint8_t parser_flags);
+uint8_t mc_probe_cycle(float *target, plan_line_data_t *pl_data, uint8_t parser_flags, float locate_rate, float retract);
+
+#ifdef ENABLE_HEIGHTMAP
+  // Probes a heightmap grid from the current position and enables Z compensation upon success.
+  uint8_t mc_probe_heightmap(float *size, uint8_t *n_points, float depth, float feed_rate);
+#endif
 
 // Performs system reset. If in motion state, kills all motion and sets system alarm.
 void mc_reset();
@@ -157,6 +157,21 @@ void delay_us(uint32_t us)
 }
 
 
+#ifdef ENABLE_EEPROM_IMAGE_COMMANDS
+// Updates a CRC-8 (polynomial 0x07) with one data byte.
+uint8_t crc8_update(uint8_t crc, uint8_t data)
+{
+  uint8_t idx;
+  crc ^= data;
+  for (idx=0; idx<8; idx++) {
+    if (crc & 0x80) { crc = (crc << 1) ^ 0x07; }
+    else { crc <<= 1; }
+  }
+  return(crc);
+}
+#endif
+
+
 // Simple hypotenuse computation function.
 float hypot_f(float x, float y) { return(sqrt(x*x + y*y)); }
 
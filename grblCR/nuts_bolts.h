@@ -71,6 +71,11 @@ void delay_ms(uint16_t ms);
 // Delays variable-defined microseconds. Compiler compatibility fix for _delay_us().
 void delay_us(uint32_t us);
 
+#ifdef ENABLE_EEPROM_IMAGE_COMMANDS
+  // Updates a CRC-8 (polynomial 0x07) with one data byte.
+  uint8_t crc8_update(uint8_t crc, uint8_t data);
+#endif
+
 // Computes hypotenuse, avoiding avr-gcc's bloated version and the extra error checking.
 float hypot_f(float x, float y);
 
@@ -36,9 +36,30 @@ typedef struct {
                                      // i.e. arcs, canned cycles, and backlash compensation.
   float previous_unit_vec[N_AXIS];   // Unit vector of previous path line segment
   float previous_nominal_speed;  // Nominal speed of previous path line segment
+  #ifdef ENABLE_RAPID_MOTION_PROFILE
+    uint8_t previous_rapid;      // True if previous path line segment is a rapid motion
+  #endif
 } planner_t;
 static planner_t pl;
 
+#ifdef ENABLE_MOTION_PROFILES
+// Motion profiles selected by M101 and up. Profile zero (M100) is the '$' settings.
+typedef struct {
+  uint8_t acceleration[N_AXIS]; // Percent of '$120'-'$122' axis accelerations
+  uint8_t max_rate[N_AXIS];     // Percent of '$110'-'$112' axis max rates
+  float junction_deviation;     // Replaces '$11' (mm)
+} motion_profile_t;
+static const motion_profile_t motion_profiles[N_MOTION_PROFILES] = MOTION_PROFILES;
+
+
+// Returns the axis max rate of a motion profile. Profile zero is the '$' settings.
+float plan_get_profile_max_rate(uint8_t motion_profile, uint8_t axis)
+{
+  if (motion_profile == 0) { return(settings.max_rate[axis]); }
+  return(settings.max_rate[axis]*(0.01*motion_profiles[motion_profile-1].max_rate[axis]));
+}
+#endif
+
 
 // Returns the index of the next block in the ring buffer. Also called by stepper segment buffer.
 uint8_t plan_next_block_index(uint8_t block_index)
@@ -280,24 +301,137 @@ static void plan_compute_profile_parameters(plan_block_t *block, float nominal_s
 }
 
 
-// Re-calculates buffered motions profile parameters upon a motion-based override change.
-void plan_update_velocity_profile_parameters()
+// Returns the number of blocks from the buffer tail to the block index. Orders ring buffer indices.
+static uint8_t plan_block_offset(uint8_t block_index)
+{
+  if (block_index >= block_buffer_tail) { return(block_index-block_buffer_tail); }
+  return(block_index+BLOCK_BUFFER_SIZE-block_buffer_tail);
+}
+
+
+// Applies new feed and rapid override values to the buffered motions. Rather than replanning the
+// whole buffer from the executing block, only the blocks from the first block with a changed maximum
+// entry speed to the buffer head are replanned, along with any blocks before it that can no longer
+// decelerate into it. Earlier blocks keep their plans. The stepper segment generator recomputes the
+// executing block only if its nominal speed or exit speed changes. Called after the new values are
+// set in sys.f_override and sys.r_override, with flags for which of the two changed.
+// NOTE: Override flags received between realtime checks are merged into a single call.
+void plan_update_override(uint8_t feed_changed, uint8_t rapid_changed)
 {
   uint8_t block_index = block_buffer_tail;
+  uint8_t first_changed = block_buffer_head;
+  uint8_t exec_changed = false;
   plan_block_t *block;
+  float max_entry_speed_sqr;
   float nominal_speed;
   float prev_nominal_speed = SOME_LARGE_VALUE; // Set high for first block nominal speed calculation.
+
+  // Check if the executing block cruise speed depends on a changed override.
+  if (block_index != block_buffer_head) {
+    block = &block_buffer[block_index];
+    if (block->condition & PL_COND_FLAG_RAPID_MOTION) { exec_changed = rapid_changed; }
+    else if (!(block->condition & PL_COND_FLAG_NO_FEED_OVERRIDE)) { exec_changed = feed_changed; }
+  }
+
+  // Re-calculate buffered motions profile parameters and locate the first changed block after the
+  // executing block. The executing block entry speed is set by the stepper, not by its limits.
   while (block_index != block_buffer_head) {
     block = &block_buffer[block_index];
+    max_entry_speed_sqr = block->max_entry_speed_sqr;
     nominal_speed = plan_compute_profile_nominal_speed(block);
     plan_compute_profile_parameters(block, nominal_speed, prev_nominal_speed);
+    if ((first_changed == block_buffer_head) && (block_index != block_buffer_tail)) {
+      if (block->max_entry_speed_sqr != max_entry_speed_sqr) { first_changed = block_index; }
+    }
     prev_nominal_speed = nominal_speed;
     block_index = plan_next_block_index(block_index);
   }
   pl.previous_nominal_speed = prev_nominal_speed; // Update prev nominal speed for next incoming block.
+
+  if (first_changed != block_buffer_head) {
+    // Reverse plan the changed blocks from a stop at the buffer head. Then walk back from the first
+    // changed block until a block that can still decelerate into its successor. The plan before it
+    // remains valid and the replan starts there.
+    float entry_speed_sqr = 0.0;
+    block_index = block_buffer_head;
+    do {
+      block_index = plan_prev_block_index(block_index);
+      block = &block_buffer[block_index];
+      entry_speed_sqr += 2*block->acceleration*block->millimeters;
+      if (entry_speed_sqr > block->max_entry_speed_sqr) { entry_speed_sqr = block->max_entry_speed_sqr; }
+      block->entry_speed_sqr = entry_speed_sqr;
+    } while (block_index != first_changed);
+    block_index = plan_prev_block_index(block_index);
+    while (block_index != block_buffer_tail) {
+      block = &block_buffer[block_index];
+      entry_speed_sqr += 2*block->acceleration*block->millimeters;
+      if (block->entry_speed_sqr <= entry_speed_sqr) { break; }
+      block->entry_speed_sqr = entry_speed_sqr; // Always < max_entry_speed_sqr here.
+      block_index = plan_prev_block_index(block_index);
+    }
+    if (block_index == block_buffer_tail) { exec_changed = true; } // Executing block exit speed may change.
+    if (plan_block_offset(block_index) < plan_block_offset(block_buffer_planned)) { block_buffer_planned = block_index; }
+  }
+
+  if (exec_changed) { st_update_plan_block_parameters(); } // Reloads executing block at current speed.
+  if (first_changed != block_buffer_head) { planner_recalculate(); }
 }
 
 
+#ifdef ENABLE_NATIVE_ARCS
+// Computes the length, axis limits, and end directions of an arc block. On entry, unit_vec[] holds the
+// chord distance of each axis (mm). On exit, unit_vec[] and exit_unit_vec[] hold the unit tangents at
+// the start and end of the arc, which the junction speed calculations use like a line direction.
+// Since the tangent sweeps the arc plane, the acceleration and rate are limited by the largest share
+// of the motion either plane axis may take. The rate is further limited, such that the centripetal
+// acceleration about the radius does not exceed the plane axes limits. The step event count is a
+// virtual step count along the arc length at the finest axis resolution, which sets the segment
+// step timing. The executed axis steps are computed per segment by the stepper module.
+static void plan_compute_arc_parameters(plan_block_t *block, float *unit_vec, float *exit_unit_vec,
+                                        float *axis_acceleration, float *axis_max_rate)
+{
+  uint8_t axis_0 = ARC_AXIS_0(block->arc_axes);
+  uint8_t axis_1 = ARC_AXIS_1(block->arc_axes);
+  uint8_t axis_linear = ARC_AXIS_LINEAR(block->arc_axes);
+  float radius = hypot_f(block->arc_radius[0], block->arc_radius[1]);
+  float plane_mm = fabs(block->arc_travel)*radius;
+  block->millimeters = hypot_f(plane_mm, unit_vec[axis_linear]);
+  float plane_ratio = plane_mm/block->millimeters; // Plane component of the unit tangent.
+  float linear_ratio = unit_vec[axis_linear]/block->millimeters;
+
+  // The CCW tangent of radius vector [r0,r1] is [-r1,r0]. Rotate the radius vector to the arc end.
+  float tangent_scalar = plane_ratio/radius;
+  if (block->arc_travel < 0.0) { tangent_scalar = -tangent_scalar; }
+  float cos_T = cos(block->arc_travel);
+  float sin_T = sin(block->arc_travel);
+  float rt_axis0 = block->arc_radius[0]*cos_T - block->arc_radius[1]*sin_T;
+  float rt_axis1 = block->arc_radius[0]*sin_T + block->arc_radius[1]*cos_T;
+  unit_vec[axis_0] = -block->arc_radius[1]*tangent_scalar;
+  unit_vec[axis_1] = block->arc_radius[0]*tangent_scalar;
+  unit_vec[axis_linear] = linear_ratio;
+  exit_unit_vec[axis_0] = -rt_axis1*tangent_scalar;
+  exit_unit_vec[axis_1] = rt_axis0*tangent_scalar;
+  exit_unit_vec[axis_linear] = linear_ratio;
+
+  float limit_vec[N_AXIS];
+  limit_vec[axis_0] = plane_ratio;
+  limit_vec[axis_1] = plane_ratio;
+  limit_vec[axis_linear] = linear_ratio;
+  block->acceleration = limit_value_by_axis_maximum(axis_acceleration, limit_vec);
+  block->rapid_rate = limit_value_by_axis_maximum(axis_max_rate, limit_vec);
+
+  // Centripetal acceleration (v*plane_ratio)^2/radius within the slower plane axis acceleration.
+  float centripetal_rate = sqrt(min(axis_acceleration[axis_0],axis_acceleration[axis_1])*radius)/plane_ratio;
+  block->rapid_rate = min(block->rapid_rate, centripetal_rate);
+
+  float max_step_per_mm = 0.0;
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) { max_step_per_mm = max(max_step_per_mm, settings.steps_per_mm[idx]); }
+  block->step_event_count = ceil(block->millimeters*max_step_per_mm);
+}
+#endif
+
+
 /* Add a new linear movement to the buffer. target[N_AXIS] is the signed, absolute target position
    in millimeters. Feed rate specifies the speed of the motion. If feed rate is inverted, the feed
    rate is taken to mean "frequency" and would complete the operation in 1/feed_rate minutes.
@@ -324,6 +458,32 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
   #ifdef USE_LINE_NUMBERS
     block->line_number = pl_data->line_number;
   #endif
+  #ifdef ENABLE_NATIVE_ARCS
+    block->arc_radius[0] = pl_data->arc_radius[0];
+    block->arc_radius[1] = pl_data->arc_radius[1];
+    block->arc_travel = pl_data->arc_travel;
+    block->arc_axes = pl_data->arc_axes;
+  #endif
+
+  // Axis limits of the motion. The block stores the limits it is planned with, so a motion profile
+  // change takes effect exactly at this block.
+  float *axis_acceleration = settings.acceleration;
+  float *axis_max_rate = settings.max_rate;
+  #ifdef ENABLE_MOTION_PROFILES
+    float profile_acceleration[N_AXIS];
+    float profile_max_rate[N_AXIS];
+    const motion_profile_t *profile = NULL;
+    if (pl_data->motion_profile) {
+      profile = &motion_profiles[pl_data->motion_profile-1];
+      uint8_t axis;
+      for (axis=0; axis<N_AXIS; axis++) {
+        profile_acceleration[axis] = settings.acceleration[axis]*(0.01*profile->acceleration[axis]);
+        profile_max_rate[axis] = plan_get_profile_max_rate(pl_data->motion_profile, axis);
+      }
+      axis_acceleration = profile_acceleration;
+      axis_max_rate = profile_max_rate;
+    }
+  #endif
 
   // Compute and store initial move distance data.
   int32_t target_steps[N_AXIS], position_steps[N_AXIS];
@@ -342,7 +502,7 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
     target_steps[idx] = lround(target[idx]*settings.steps_per_mm[idx]);
     block->steps[idx] = labs(target_steps[idx]-position_steps[idx]);
     block->step_event_count = max(block->step_event_count, block->steps[idx]);
-    delta_mm = (target_steps[idx] - position_steps[idx])/settings.steps_per_mm[idx];
+    delta_mm = (target_steps[idx] - position_steps[idx])*settings_derived.mm_per_step[idx];
 
     unit_vec[idx] = delta_mm; // Store unit vector numerator
 
@@ -350,6 +510,16 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
     if (delta_mm < 0.0 ) { block->direction_bits |= get_direction_pin_mask(idx); }
   }
 
+  #ifdef ENABLE_NATIVE_ARCS
+    // Direction of the motion at its end. Differs from the start direction for arcs.
+    float exit_unit_vec[N_AXIS];
+    if (block->arc_travel != 0.0) {
+      // A full circle has no chord steps, so the empty block check uses the arc length.
+      plan_compute_arc_parameters(block, unit_vec, exit_unit_vec, axis_acceleration, axis_max_rate);
+      if (block->step_event_count == 0) { return(PLAN_EMPTY_BLOCK); }
+    } else {
+  #endif
+
   // Bail if this is a zero-length block. Highly unlikely to occur.
   if (block->step_event_count == 0) { return(PLAN_EMPTY_BLOCK); }
 
@@ -358,8 +528,16 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
   // NOTE: This calculation assumes all axes are orthogonal (Cartesian) and works with ABC-axes,
   // if they are also orthogonal/independent. Operates on the absolute value of the unit vector.
   block->millimeters = convert_delta_vector_to_unit_vector(unit_vec);
-  block->acceleration = limit_value_by_axis_maximum(settings.acceleration, unit_vec);
-  block->rapid_rate = limit_value_by_axis_maximum(settings.max_rate, unit_vec);
+  block->acceleration = limit_value_by_axis_maximum(axis_acceleration, unit_vec);
+  block->rapid_rate = limit_value_by_axis_maximum(axis_max_rate, unit_vec);
+
+  #ifdef ENABLE_NATIVE_ARCS
+      memcpy(exit_unit_vec, unit_vec, sizeof(unit_vec));
+    }
+  #endif
+  #ifdef ENABLE_RAPID_MOTION_PROFILE
+    if (block->condition & PL_COND_FLAG_RAPID_MOTION) { block->acceleration *= (0.01*RAPID_ACCELERATION_PERCENT); }
+  #endif
 
   // Store programmed rate.
   if (block->condition & PL_COND_FLAG_RAPID_MOTION) { block->programmed_rate = block->rapid_rate; }
@@ -416,10 +594,25 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
         block->max_junction_speed_sqr = SOME_LARGE_VALUE;
       } else {
         convert_delta_vector_to_unit_vector(junction_unit_vec);
-        float junction_acceleration = limit_value_by_axis_maximum(settings.acceleration, junction_unit_vec);
+        float junction_acceleration = limit_value_by_axis_maximum(axis_acceleration, junction_unit_vec);
         float sin_theta_d2 = sqrt(0.5*(1.0-junction_cos_theta)); // Trig half angle identity. Always positive.
+        float junction_deviation = settings.junction_deviation;
+        #ifdef ENABLE_MOTION_PROFILES
+          if (profile != NULL) { junction_deviation = profile->junction_deviation; }
+        #endif
+        #ifdef ENABLE_PATH_BLENDING
+          if (pl_data->junction_deviation > 0.0) { junction_deviation = pl_data->junction_deviation; } // G64
+        #endif
+        #ifdef ENABLE_RAPID_MOTION_PROFILE
+          // Only a junction between two rapids uses the rapid profile. G0/G1 transitions keep the
+          // cutting limits, since the tool may be engaged on either side of the corner.
+          if (pl.previous_rapid && (block->condition & PL_COND_FLAG_RAPID_MOTION)) {
+            junction_acceleration *= (0.01*RAPID_ACCELERATION_PERCENT);
+            junction_deviation = RAPID_JUNCTION_DEVIATION;
+          }
+        #endif
         block->max_junction_speed_sqr = max( MINIMUM_JUNCTION_SPEED*MINIMUM_JUNCTION_SPEED,
-                       (junction_acceleration * settings.junction_deviation * sin_theta_d2)/(1.0-sin_theta_d2) );
+                       (junction_acceleration * junction_deviation * sin_theta_d2)/(1.0-sin_theta_d2) );
       }
     }
   }
@@ -431,7 +624,14 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
     pl.previous_nominal_speed = nominal_speed;
     
     // Update previous path unit_vector and planner position.
-    memcpy(pl.previous_unit_vec, unit_vec, sizeof(unit_vec)); // pl.previous_unit_vec[] = unit_vec[]
+    #ifdef ENABLE_NATIVE_ARCS
+      memcpy(pl.previous_unit_vec, exit_unit_vec, sizeof(exit_unit_vec));
+    #else
+      memcpy(pl.previous_unit_vec, unit_vec, sizeof(unit_vec)); // pl.previous_unit_vec[] = unit_vec[]
+    #endif
+    #ifdef ENABLE_RAPID_MOTION_PROFILE
+      pl.previous_rapid = (block->condition & PL_COND_FLAG_RAPID_MOTION);
+    #endif
     memcpy(pl.position, target_steps, sizeof(target_steps)); // pl.position[] = target_steps[]
 
     // New block is all set. Update buffer head and next buffer head indices.
@@ -445,6 +645,36 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
 }
 
 
+#ifdef PLAN_SPINDLE_AND_DWELL_EVENTS
+// Add a dwell to the buffer. The dwell block has no steps or distance, and its entry and exit speeds
+// are zero, so the planner decelerates the preceding motion to a stop and starts the following motion
+// from rest. The dwell time is stored in milliseconds in step_event_count and is executed by the
+// segment generator as stepless timer ticks. The block also carries the spindle state and speed.
+// NOTE: Assumes buffer is available, like plan_buffer_line().
+uint8_t plan_buffer_dwell(float seconds, plan_line_data_t *pl_data)
+{
+  plan_block_t *block = &block_buffer[block_buffer_head];
+  memset(block,0,sizeof(plan_block_t)); // Zero all block values. Entry speeds and distance are zero.
+  block->condition = (pl_data->condition & PL_COND_ACCESSORY_MASK) | PL_COND_FLAG_DWELL;
+  block->spindle_speed = pl_data->spindle_speed;
+  #ifdef USE_LINE_NUMBERS
+    block->line_number = pl_data->line_number;
+  #endif
+  block->step_event_count = ceil(1000.0*seconds); // Dwell time in milliseconds.
+  if (block->step_event_count == 0) { return(PLAN_EMPTY_BLOCK); }
+
+  // Next motion starts from rest. Clear previous path data used for the junction speed.
+  pl.previous_nominal_speed = 0.0;
+  memset(pl.previous_unit_vec, 0, sizeof(pl.previous_unit_vec));
+
+  block_buffer_head = next_buffer_head;
+  next_buffer_head = plan_next_block_index(block_buffer_head);
+  planner_recalculate();
+  return(PLAN_OK);
+}
+#endif
+
+
 // Reset the planner position vectors. Called by the system abort/initialization routine.
 void plan_sync_position()
 {
@@ -457,6 +687,13 @@ void plan_sync_position()
 }
 
 
+// Returns the planner position of the last buffered motion in machine coordinates (mm).
+void plan_get_planner_mpos(float *target)
+{
+  system_convert_array_steps_to_mpos(target,pl.position);
+}
+
+
 // Returns the number of available blocks are in the planner buffer.
 uint8_t plan_get_block_buffer_available()
 {
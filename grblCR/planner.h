@@ -45,10 +45,22 @@
 #define PL_COND_FLAG_INVERSE_TIME      bit(3) // Interprets feed rate value as inverse time when set.
 #define PL_COND_FLAG_SPINDLE_CW        bit(4)
 #define PL_COND_FLAG_SPINDLE_CCW       bit(5)
+#define PL_COND_FLAG_DWELL             bit(6) // Timed zero-motion block. step_event_count is the dwell time in ms.
+#ifdef ENABLE_HEIGHTMAP
+  #define PL_COND_FLAG_NO_HEIGHTMAP    bit(7) // Motion is not heightmap compensated. Used by probe motions.
+#endif
 #define PL_COND_MOTION_MASK    (PL_COND_FLAG_RAPID_MOTION|PL_COND_FLAG_SYSTEM_MOTION|PL_COND_FLAG_NO_FEED_OVERRIDE)
 #define PL_COND_SPINDLE_MASK   (PL_COND_FLAG_SPINDLE_CW|PL_COND_FLAG_SPINDLE_CCW)
 #define PL_COND_ACCESSORY_MASK (PL_COND_FLAG_SPINDLE_CW|PL_COND_FLAG_SPINDLE_CCW)
 
+#ifdef ENABLE_NATIVE_ARCS
+  // Packs and unpacks the arc plane first, second, and linear axis indices of an arc block.
+  #define ARC_AXES(axis_0,axis_1,axis_linear) ((axis_0)|((axis_1)<<2)|((axis_linear)<<4))
+  #define ARC_AXIS_0(arc_axes)      ((arc_axes) & 0x03)
+  #define ARC_AXIS_1(arc_axes)      (((arc_axes) >> 2) & 0x03)
+  #define ARC_AXIS_LINEAR(arc_axes) (((arc_axes) >> 4) & 0x03)
+#endif
+
 
 // This struct stores a linear movement of a g-code block motion with its critical "nominal" values
 // are as specified in the source g-code.
@@ -82,6 +94,12 @@ typedef struct {
   // Stored spindle speed data used by spindle overrides and resuming methods.
   float spindle_speed;    // Block spindle speed. Copied from pl_line_data.
 
+  #ifdef ENABLE_NATIVE_ARCS
+    // Arc geometry traced by the step segment generator. steps[] and direction_bits hold the chord.
+    float arc_radius[2];  // Radius vector from arc center to start point in the arc plane (mm)
+    float arc_travel;     // Signed angular travel (rad). CCW positive. Zero for a line motion.
+    uint8_t arc_axes;     // Arc plane and linear axes. See ARC_AXIS macros.
+  #endif
 } plan_block_t;
 
 
@@ -93,6 +111,17 @@ typedef struct {
   #ifdef USE_LINE_NUMBERS
     int32_t line_number;    // Desired line number to report when executing.
   #endif
+  #ifdef ENABLE_PATH_BLENDING
+    float junction_deviation; // G64 corner tolerance (mm) of the motion. Zero uses the '$11' setting.
+  #endif
+  #ifdef ENABLE_MOTION_PROFILES
+    uint8_t motion_profile;   // Motion profile of the motion. Zero uses the '$' settings.
+  #endif
+  #ifdef ENABLE_NATIVE_ARCS
+    float arc_radius[2];      // Arc motion geometry. Set by mc_arc() only. Same as plan_block_t.
+    float arc_travel;
+    uint8_t arc_axes;
+  #endif
 } plan_line_data_t;
 
 
@@ -105,6 +134,11 @@ void plan_reset_buffer(); // Reset buffer only.
 // rate is taken to mean "frequency" and would complete the operation in 1/feed_rate minutes.
 uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data);
 
+#ifdef PLAN_SPINDLE_AND_DWELL_EVENTS
+  // Add a dwell to the buffer. Executed as a timed, zero-motion block by the segment generator.
+  uint8_t plan_buffer_dwell(float seconds, plan_line_data_t *pl_data);
+#endif
+
 // Called when the current block is no longer needed. Discards the block and makes the memory
 // availible for new blocks.
 void plan_discard_current_block();
@@ -124,8 +158,13 @@ float plan_get_exec_block_exit_speed_sqr();
 // Called by main program during planner calculations and step segment buffer during initialization.
 float plan_compute_profile_nominal_speed(plan_block_t *block);
 
-// Re-calculates buffered motions profile parameters upon a motion-based override change.
-void plan_update_velocity_profile_parameters();
+#ifdef ENABLE_MOTION_PROFILES
+  // Returns the axis max rate of a motion profile. Profile zero is the '$' settings.
+  float plan_get_profile_max_rate(uint8_t motion_profile, uint8_t axis);
+#endif
+
+// Replans the part of the buffer affected by new feed and rapid override values in sys.
+void plan_update_override(uint8_t feed_changed, uint8_t rapid_changed);
 
 // Reset the planner position vector (in steps)
 void plan_sync_position();
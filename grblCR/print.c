@@ -94,6 +94,17 @@ void print_uint8_base2_ndigit(uint8_t n, uint8_t digits) {
 }
 
 
+#ifdef ENABLE_EEPROM_IMAGE_COMMANDS
+// Prints an uint8 variable in base 16 as two upper case digits.
+void print_uint8_base16(uint8_t n) {
+  uint8_t digit = n >> 4;
+  serial_write(digit + (digit < 10 ? '0' : 'A'-10));
+  digit = n & 0x0F;
+  serial_write(digit + (digit < 10 ? '0' : 'A'-10));
+}
+#endif
+
+
 void print_uint32_base10(uint32_t n)
 {
   if (n == 0) {
@@ -144,11 +155,22 @@ void printFloat(float n, uint8_t decimal_places)
   }
   if (decimals) { n *= 10; }
   n += 0.5; // Add rounding factor. Ensures carryover through entire value.
+  print_uint32_fixed((long)n, decimal_places);
+}
 
+
+// Prints an unsigned fixed-point integer, scaled by 10^decimal_places, in the same format as
+// printFloat(). Remaining digits are generated with 16-bit math once the value fits.
+void print_uint32_fixed(uint32_t n, uint8_t decimal_places)
+{
   // Generate digits backwards and store in string.
   unsigned char buf[13];
   uint8_t i = 0;
-  uint32_t a = (long)n;
+  while(n > 0xFFFF) {
+    buf[i++] = (n % 10) + '0'; // Get digit
+    n /= 10;
+  }
+  uint16_t a = n;
   while(a > 0) {
     buf[i++] = (a % 10) + '0'; // Get digit
     a /= 10;
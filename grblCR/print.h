@@ -37,8 +37,16 @@ void print_uint8_base10(uint8_t n);
 // Prints an uint8 variable in base 2 with desired number of desired digits.
 void print_uint8_base2_ndigit(uint8_t n, uint8_t digits);
 
+#ifdef ENABLE_EEPROM_IMAGE_COMMANDS
+  // Prints an uint8 variable in base 16 as two digits.
+  void print_uint8_base16(uint8_t n);
+#endif
+
 void printFloat(float n, uint8_t decimal_places);
 
+// Prints an unsigned integer scaled by 10^decimal_places in the same format as printFloat().
+void print_uint32_fixed(uint32_t n, uint8_t decimal_places);
+
 // Floating value printing handlers for special variables types used in Grbl.
 //  - CoordValue: Handles all position or coordinate values in inches or mm reporting.
 //  - RateValue: Handles feed rate and current velocity in inches or mm reporting.
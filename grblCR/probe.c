@@ -24,6 +24,14 @@
 // Inverts the probe pin state depending on user settings and probing cycle mode.
 uint8_t probe_invert_mask;
 
+#ifdef PROBE_SUBSTEP_INTERPOLATION
+  static float probe_substep_offset[N_AXIS]; // Sub-step offset of sys_probe_position in steps.
+#endif
+
+#ifdef ENABLE_HEIGHTMAP
+  heightmap_t heightmap;
+#endif
+
 //Pin change interrupt for probe
 // ISR needs to run as fast as possible.
 // Sets only the realtime command execute variable; the main program executes these when
@@ -32,6 +40,9 @@ uint8_t probe_invert_mask;
 ISR(PCINT1_vect)
 {
   //Probe signal is noisy, so reading it (again) here is unreliable.
+  #ifdef PROBE_SUBSTEP_INTERPOLATION
+    st_probe_capture_edge(); // Timestamp edge first.
+  #endif
   PCMSK1 &= ~(PROBE_MASK); //disable probe interrupt vector (to prevent probe interrupts when not probing).
   sys.probe_interrupt_occurred = 1; //log that probe occurred
 }
@@ -74,6 +85,57 @@ void probe_state_monitor()
   if (sys.probe_interrupt_occurred) { //changed from 'probe_get_state()'
     sys_probe_state = PROBE_OFF;
     memcpy(sys_probe_position, sys_position, sizeof(sys_position));
+    #ifdef PROBE_SUBSTEP_INTERPOLATION
+      st_probe_capture_trip();
+    #endif
     bit_true(sys_rt_exec_state, EXEC_MOTION_CANCEL);
   }
 }
+
+
+// Called by mc_probe_cycle() after sys_probe_position is updated. Sets the sub-step offset of the
+// probe position, if enabled. Zero when the position was not recorded by a probe trip.
+void probe_update_position_offset(uint8_t is_tripped)
+{
+  #ifdef PROBE_SUBSTEP_INTERPOLATION
+    if (is_tripped) { st_probe_get_substep_offset(probe_substep_offset); }
+    else { memset(probe_substep_offset, 0, sizeof(probe_substep_offset)); }
+  #endif
+}
+
+
+// Returns the last probe position in machine coordinates (mm), including any sub-step offset.
+void probe_get_mpos(float *position)
+{
+  system_convert_array_steps_to_mpos(position,sys_probe_position);
+  #ifdef PROBE_SUBSTEP_INTERPOLATION
+    uint8_t idx;
+    for (idx=0; idx<N_AXIS; idx++) { position[idx] += probe_substep_offset[idx]*settings_derived.mm_per_step[idx]; }
+  #endif
+}
+
+
+#ifdef ENABLE_HEIGHTMAP
+// Returns the bilinear-interpolated heightmap Z offset in mm at the XY position of target.
+// Positions outside the grid use the height at the nearest grid edge.
+// NOTE: Called by mc_line() for every compensated line segment. Keep it light-weight.
+float probe_get_heightmap_offset(float *target)
+{
+  uint8_t cell[2];
+  float frac[2];
+  uint8_t idx;
+  for (idx=0; idx<2; idx++) {
+    float pos = (target[idx]-heightmap.origin[idx])/heightmap.spacing[idx]; // In grid point units.
+    if (pos <= 0.0) { pos = 0.0; }
+    else if (pos >= heightmap.n_points[idx]-1) { pos = heightmap.n_points[idx]-1; }
+    cell[idx] = trunc(pos);
+    if (cell[idx] == heightmap.n_points[idx]-1) { cell[idx]--; } // Use last cell at far grid edge.
+    frac[idx] = pos-cell[idx];
+  }
+  int16_t *z = &heightmap.z[cell[Y_AXIS]*heightmap.n_points[X_AXIS]+cell[X_AXIS]];
+  float z_y0 = z[0] + frac[X_AXIS]*(z[1]-z[0]);
+  z += heightmap.n_points[X_AXIS]; // Next row
+  float z_y1 = z[0] + frac[X_AXIS]*(z[1]-z[0]);
+  return(0.001*(z_y0 + frac[Y_AXIS]*(z_y1-z_y0)));
+}
+#endif
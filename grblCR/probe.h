@@ -21,6 +21,19 @@
 #ifndef probe_h
 #define probe_h
 
+#ifdef ENABLE_HEIGHTMAP
+  #define HEIGHTMAP_MAX_POINTS (HEIGHTMAP_MAX_POINTS_X*HEIGHTMAP_MAX_POINTS_Y)
+
+  // Bed heightmap grid. Probed by '$P=' and applied to line motions by mc_line().
+  typedef struct {
+    float origin[2];                 // Machine XY position of the first grid point in mm.
+    float spacing[2];                // Grid point spacing along X and Y in mm. May be negative.
+    uint8_t n_points[2];             // Number of grid points along X and Y. Zero if no heightmap is loaded.
+    int16_t z[HEIGHTMAP_MAX_POINTS]; // Heights relative to the first grid point in microns. Row (X) major.
+  } heightmap_t;
+  extern heightmap_t heightmap;
+#endif
+
 // Values that define the probing state machine.
 #define PROBE_OFF     0 // Probing disabled or not in use. (Must be zero.)
 #define PROBE_ACTIVE  1 // Actively watching the input pin.
@@ -40,4 +53,16 @@ uint8_t probe_get_state();
 // stepper ISR per ISR tick.
 void probe_state_monitor();
 
+// Sets the sub-step offset of sys_probe_position after a probe cycle. Zero, if not tripped.
+void probe_update_position_offset(uint8_t is_tripped);
+
+// Returns the last probe position in machine coordinates (mm).
+void probe_get_mpos(float *position);
+
+#ifdef ENABLE_HEIGHTMAP
+  // Returns the bilinear-interpolated heightmap Z offset in mm at the XY position of target.
+  // Positions outside the grid use the height at the nearest grid edge.
+  float probe_get_heightmap_offset(float *target);
+#endif
+
 #endif
@@ -31,6 +31,34 @@ static char line[LINE_BUFFER_SIZE]; // Line to be executed. Zero-terminated.
 
 static void protocol_exec_rt_suspend();
 
+#ifdef ENABLE_PROGRAM_MODE
+  // Program mode state and statistics. A program runs between two '%' lines.
+  typedef struct {
+    uint8_t active;   // True between the opening and closing '%'
+    uint32_t lines;   // Executed g-code lines
+    uint16_t errors;  // G-code lines rejected with an error
+    uint16_t stops;   // Times motion came to rest before the end of the program
+    uint8_t line_tick; // sys_tick when the last line was received
+  } program_t;
+  static program_t program;
+
+  // Executes a '%' line. The opening '%' starts a program and clears its statistics. The closing
+  // '%' starts any queued motion, waits for it to complete, and reports the program statistics.
+  static void protocol_execute_program_delimiter()
+  {
+    if (!program.active) {
+      memset(&program,0,sizeof(program_t));
+      program.active = true;
+      report_feedback_message(MESSAGE_PROGRAM_START);
+    } else {
+      program.active = false; // Final stop doesn't count.
+      protocol_buffer_synchronize();
+      if (sys.abort) { return; }
+      report_program_statistics(program.lines, program.errors, program.stops);
+    }
+  }
+#endif
+
 /*
   GRBL PRIMARY LOOP:
 */
@@ -48,6 +76,9 @@ void protocol_main_loop()
     // All systems go!
     system_execute_startup(line); // Execute startup script.
   }
+  #ifdef ENABLE_PROGRAM_MODE
+    program.active = false; // A reset ends the running program.
+  #endif
 
   // ---------------------------------------------------------------------------------
   // Primary loop! Upon a system abort, this exits back to main() to reset the system.
@@ -69,6 +100,9 @@ void protocol_main_loop()
         if (sys.abort) { return; } // Bail to calling function upon system abort
 
         line[char_counter] = 0; // Set string termination character.
+        #ifdef ENABLE_PROGRAM_MODE
+          program.line_tick = sys_tick; // Restart the auto-start fallback timeout.
+        #endif
         #ifdef REPORT_ECHO_LINE_RECEIVED
           report_echo_line_received(line);
         #endif
@@ -84,6 +118,13 @@ void protocol_main_loop()
           // Empty or comment line. For syncing purposes.    
           report_status_message(STATUS_OK);
         
+        #ifdef ENABLE_EEPROM_IMAGE_COMMANDS
+        } else if (settings_image_stale && !((line[0] == '$') && (line[1] == 'E'))) {
+          // EEPROM image written. Only '$E' commands until reset reloads settings.
+          report_echo_line_received(line);
+          report_status_message(STATUS_EEPROM_IMAGE_ERROR);
+        #endif
+
         } else if (line[0] == '$') {
           // Grbl '$' system command
           line_errors = system_execute_line(line);
@@ -94,12 +135,31 @@ void protocol_main_loop()
           // Everything else is gcode. 
           report_echo_line_received(line);
           report_status_message(STATUS_SYSTEM_GC_LOCK);
-        
+
+        #ifdef ENABLE_PROGRAM_MODE
+        } else if (line[0] == '%') {
+          // Program start or end delimiter. Must be alone on its line.
+          line_errors = STATUS_INVALID_STATEMENT;
+          if (line[1] == 0) {
+            protocol_execute_program_delimiter();
+            if (sys.abort) { return; }
+            line_errors = STATUS_OK;
+          }
+          if(line_errors){report_echo_line_received(line);}
+          report_status_message(line_errors);
+        #endif
+
         } else {
           // Parse and execute g-code block.
           line_errors = gc_execute_line(line);
           if(line_errors){report_echo_line_received(line);}
           report_status_message(line_errors);
+          #ifdef ENABLE_PROGRAM_MODE
+            if (program.active) {
+              program.lines++;
+              if (line_errors) { program.errors++; }
+            }
+          #endif
         }
 
         // Reset tracking data for next line.
@@ -129,13 +189,8 @@ void protocol_main_loop()
           } else if (c == ';') {
             // NOTE: ';' comment to EOL is a LinuxCNC definition. Not NIST.
             line_flags |= LINE_FLAG_COMMENT_SEMICOLON;
-          // TODO: Install '%' feature
-          // } else if (c == '%') {
-            // Program start-end percent sign NOT SUPPORTED.
-            // NOTE: This maybe installed to tell Grbl when a program is running vs manual input,
-            // where, during a program, the system auto-cycle start will continue to execute
-            // everything until the next '%' sign. This will help fix resuming issues with certain
-            // functions that empty the planner buffer to execute its task on-time.
+          // NOTE: A '%' program start-end percent sign is passed on as a line of its own. It is
+          // handled upon EOL when ENABLE_PROGRAM_MODE is enabled, and rejected as g-code otherwise.
           } else if (char_counter >= (LINE_BUFFER_SIZE-1)) {
             // Detect line buffer overflow and set flag.
             line_flags |= LINE_FLAG_OVERFLOW;
@@ -152,6 +207,14 @@ void protocol_main_loop()
     // If there are no more characters in the serial read buffer to be processed and executed,
     // this indicates that g-code streaming has either filled the planner buffer or has
     // completed. In either case, auto-cycle start, if enabled, any queued moves.
+    // NOTE: Within a program, an idle machine instead waits for a full planner buffer, a buffer sync,
+    // or the end of the program, so a pause in streaming doesn't start it on a short plan. If no line
+    // arrives for PROGRAM_AUTO_START_TIMEOUT, queued motion starts anyway, so a program that is never
+    // closed with '%' doesn't strand it.
+    #ifdef ENABLE_PROGRAM_MODE
+      if (!(program.active && (sys.state == STATE_IDLE) &&
+            ((uint8_t)(sys_tick-program.line_tick) < (PROGRAM_AUTO_START_TIMEOUT/SYSTEM_TICK_MS))))
+    #endif
     protocol_auto_cycle_start();
 
     protocol_execute_realtime();  // Runtime command check point.
@@ -204,9 +267,70 @@ void protocol_execute_realtime()
 {
   protocol_exec_rt_system();
   if (sys.suspend) { protocol_exec_rt_suspend(); }
+  #ifdef ENABLE_VELOCITY_JOG
+    jog_velocity_update(); // Keep velocity jog blocks queued ahead of the steppers.
+  #endif
 }
 
 
+#ifdef ENABLE_AUTO_STATUS_REPORT
+static uint8_t auto_report_ticks; // Watchdog ticks since the last status report.
+static uint8_t auto_report_state; // System state at the last status report.
+#ifdef USE_LINE_NUMBERS
+  static int32_t auto_report_line; // Executing line number at the last status report.
+#endif
+
+#ifdef USE_LINE_NUMBERS
+static int32_t protocol_auto_report_current_line()
+{
+  #ifdef REPORT_REALTIME_SNAPSHOT
+    st_snapshot_t snapshot;
+    st_get_snapshot(&snapshot);
+    return(snapshot.line_number);
+  #else
+    plan_block_t *block = plan_get_current_block();
+    if (block == NULL) { return(0); }
+    return(block->line_number);
+  #endif
+}
+#endif
+
+
+// Records what the host was last sent in a status report.
+static void protocol_auto_report_sync()
+{
+  auto_report_ticks = 0;
+  auto_report_state = sys.state;
+  #ifdef USE_LINE_NUMBERS
+    auto_report_line = protocol_auto_report_current_line();
+  #endif
+}
+
+
+// Called upon each watchdog tick. Pushes a status report when the '$10' interval elapses or, if
+// enabled, when the state or executing line number changes. The push is deferred to a later tick
+// while the serial TX buffer lacks room for a report, so it never waits on the serial port.
+static void protocol_auto_report()
+{
+  uint8_t push = false;
+  if (auto_report_ticks < 255) { auto_report_ticks++; }
+  if (bit_istrue(settings.status_report_mask,BITFLAG_RT_STATUS_AUTO_INTERVAL)) {
+    if (auto_report_ticks >= (STATUS_AUTO_REPORT_INTERVAL/SYSTEM_TICK_MS)) { push = true; }
+  }
+  if (bit_istrue(settings.status_report_mask,BITFLAG_RT_STATUS_AUTO_CHANGE)) {
+    if (sys.state != auto_report_state) { push = true; }
+    #ifdef USE_LINE_NUMBERS
+      if (protocol_auto_report_current_line() != auto_report_line) { push = true; }
+    #endif
+  }
+  if (!push) { return; }
+  if ((TX_BUFFER_SIZE-serial_get_tx_buffer_count()) < STATUS_REPORT_BASE_LENGTH) { return; }
+  report_realtime_status(true);
+  protocol_auto_report_sync();
+}
+#endif
+
+
 // Executes run-time commands, when required. This function primarily operates as Grbl's state
 // machine and controls the various real-time features Grbl has to offer.
 // NOTE: Do not alter this unless you know exactly what you are doing!
@@ -252,10 +376,20 @@ void protocol_exec_rt_system()
 
     // Execute and serial print status
     if (rt_exec & EXEC_STATUS_REPORT) {
-      report_realtime_status();
+      report_realtime_status(false);
       system_clear_exec_state_flag(EXEC_STATUS_REPORT);
+      #ifdef ENABLE_AUTO_STATUS_REPORT
+        protocol_auto_report_sync(); // Restart interval. Host already has current data.
+      #endif
     }
 
+    #ifdef ENABLE_AUTO_STATUS_REPORT
+      if (rt_exec & EXEC_AUTO_REPORT) {
+        system_clear_exec_state_flag(EXEC_AUTO_REPORT);
+        protocol_auto_report();
+      }
+    #endif
+
     // NOTE: Once hold is initiated, the system immediately enters a suspend state to block all
     // main program processes until either reset or resumed. This ensures a hold completes safely.
     if (rt_exec & (EXEC_MOTION_CANCEL | EXEC_FEED_HOLD | EXEC_SLEEP)) {
@@ -350,6 +484,9 @@ void protocol_exec_rt_system()
           gc_sync_position();
           plan_sync_position();
         }       
+        #ifdef ENABLE_PROGRAM_MODE
+          if (program.active && (sys.state == STATE_CYCLE)) { program.stops++; }
+        #endif
         sys.suspend = SUSPEND_DISABLE;
         sys.state = STATE_IDLE;   
       }
@@ -377,11 +514,12 @@ void protocol_exec_rt_system()
     if (rt_exec & EXEC_RAPID_OVR_LOW) { new_r_override = RAPID_OVERRIDE_LOW; }
 
     if ((new_f_override != sys.f_override) || (new_r_override != sys.r_override)) {
+      uint8_t feed_changed = (new_f_override != sys.f_override);
+      uint8_t rapid_changed = (new_r_override != sys.r_override);
       sys.f_override = new_f_override;
       sys.r_override = new_r_override;
       sys.report_ovr_counter = 0; // Set to report change immediately
-      plan_update_velocity_profile_parameters();
-      plan_cycle_reinitialize();
+      plan_update_override(feed_changed, rapid_changed);
     }
   }
 
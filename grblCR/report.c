@@ -45,6 +45,29 @@ static void report_util_axis_values(float *axis_value) {
     if (idx < (N_AXIS-1)) { serial_write(','); }
   }
 }
+#ifdef ENABLE_AUTO_STATUS_REPORT
+  // Free bytes in the serial TX buffer.
+  static uint8_t report_util_tx_available() { return(TX_BUFFER_SIZE-serial_get_tx_buffer_count()); }
+#endif
+#ifdef REPORT_INTEGER_POSITION
+  // Prints axis positions directly from step counts, less an optional offset in mm. Same output
+  // format as report_util_axis_values(), but scaled to report units in one multiply and printed
+  // with integer digits, instead of converting to mm and scaling each digit in printFloat().
+  static void report_util_axis_steps(int32_t *steps, float *offset) {
+    uint8_t idx;
+    float value;
+    for (idx=0; idx<N_AXIS; idx++) {
+      value = steps[idx]*settings_derived.coord_scale[idx]; // Report units
+      if (offset) { value -= offset[idx]*settings_derived.coord_unit_scale; }
+      if (value < 0) {
+        serial_write('-');
+        value = -value;
+      }
+      print_uint32_fixed(value+0.5, settings_derived.coord_decimals);
+      if (idx < (N_AXIS-1)) { serial_write(','); }
+    }
+  }
+#endif
 
 
 // Text printed in front of each grbl setting ($$)
@@ -230,6 +253,9 @@ void report_alarm_message(uint8_t alarm_code)
     case EXEC_ALARM_HOMING_FAIL_APPROACH:
       printPgmString(PSTR("home")); 
       break;
+    case EXEC_ALARM_SPINDLE_AT_SPEED:
+      printPgmString(PSTR("spindle"));
+      break;
   }
   report_util_feedback_line_feed(); //"]\r\n"
   printPgmString(PSTR("ALARM:"));
@@ -266,6 +292,10 @@ void report_feedback_message(uint8_t message_code)
       printPgmString(PSTR("Restore:spindle")); break;
     case MESSAGE_SLEEP_MODE:
       printPgmString(PSTR("Sleep")); break;
+    #ifdef ENABLE_PROGRAM_MODE
+      case MESSAGE_PROGRAM_START:
+        printPgmString(PSTR("Pgm Start")); break;
+    #endif
     default: //shouldn't ever get here,
       break;
   }
@@ -288,9 +318,18 @@ void report_grbl_help()
   printPgmString(PSTR("[$G state")); report_util_feedback_line_feed();
   printPgmString(PSTR("[$I version")); report_util_feedback_line_feed();
   printPgmString(PSTR("[$L levelX")); report_util_feedback_line_feed();
+  #ifdef ENABLE_HEIGHTMAP
+    printPgmString(PSTR("[$P heightmap")); report_util_feedback_line_feed();
+  #endif
+  #ifdef ENABLE_VELOCITY_JOG
+    printPgmString(PSTR("[$JV velocity jog")); report_util_feedback_line_feed();
+  #endif
   printPgmString(PSTR("[$C check")); report_util_feedback_line_feed();
   printPgmString(PSTR("[$# offsets")); report_util_feedback_line_feed();
   printPgmString(PSTR("[$$ settings")); report_util_feedback_line_feed();
+  #ifdef ENABLE_SETTINGS_TRANSACTION
+    printPgmString(PSTR("[$T transaction")); report_util_feedback_line_feed();
+  #endif
   printPgmString(PSTR("[$_=_ set")); report_util_feedback_line_feed();
 }
 
@@ -346,7 +385,7 @@ void report_probe_parameters()
   // Report in terms of machine position.
   printPgmString(PSTR("[PRB:"));
   float print_position[N_AXIS];
-  system_convert_array_steps_to_mpos(print_position,sys_probe_position);
+  probe_get_mpos(print_position);
   report_util_axis_values(print_position);
   serial_write(':');
   print_uint8_base10(sys.probe_succeeded);
@@ -391,6 +430,10 @@ void report_gcode_modes()
   if (gc_state.modal.motion >= MOTION_MODE_PROBE_TOWARD) {
     printPgmString(PSTR("38."));
     print_uint8_base10(gc_state.modal.motion - (MOTION_MODE_PROBE_TOWARD-2));
+  #ifdef ENABLE_SPLINES
+  } else if (gc_state.modal.motion == MOTION_MODE_QUADRATIC_SPLINE) {
+    printPgmString(PSTR("5.1"));
+  #endif
   } else {
     print_uint8_base10(gc_state.modal.motion);
   }
@@ -410,6 +453,17 @@ void report_gcode_modes()
   report_util_gcode_modes_G();
   print_uint8_base10(94-gc_state.modal.feed_rate);
 
+  #ifdef ENABLE_PATH_BLENDING
+    report_util_gcode_modes_G();
+    if (gc_state.modal.control == CONTROL_MODE_CONTINUOUS) { printPgmString(PSTR("64")); }
+    else { printPgmString(PSTR("61")); }
+  #endif
+
+  #ifdef ENABLE_CANNED_CYCLES
+    report_util_gcode_modes_G();
+    print_uint8_base10(gc_state.modal.retract+98);
+  #endif
+
   if (gc_state.modal.program_flow) {
     report_util_gcode_modes_M();
     switch (gc_state.modal.program_flow) {
@@ -431,6 +485,11 @@ void report_gcode_modes()
 
   report_util_gcode_modes_M();
   serial_write('9'); //Report that coolant is disabled (CR doesn't have coolant)
+
+  #ifdef ENABLE_MOTION_PROFILES
+    report_util_gcode_modes_M();
+    print_uint8_base10(gc_state.modal.motion_profile+100);
+  #endif
   
   printPgmString(PSTR(" T"));
   print_uint8_base10(gc_state.tool);
@@ -461,6 +520,47 @@ void report_manf_notes(char *line)
   report_util_line_feed();
 }
 
+#ifdef ENABLE_HEIGHTMAP
+// Prints heightmap grid ($P). First line is [HMAP:nx,ny,x0,y0,dx,dy], followed by one line of
+// heights per grid row in mm, relative to the first grid point. nx=0 when no heightmap is loaded.
+void report_heightmap()
+{
+  uint8_t i, j;
+  printPgmString(PSTR("[HMAP:"));
+  print_uint8_base10(heightmap.n_points[X_AXIS]);
+  serial_write(',');
+  print_uint8_base10(heightmap.n_points[Y_AXIS]);
+  for (i=0; i<2; i++) { serial_write(','); printFloat_CoordValue(heightmap.origin[i]); }
+  for (i=0; i<2; i++) { serial_write(','); printFloat_CoordValue(heightmap.spacing[i]); }
+  report_util_feedback_line_feed();
+  if (!heightmap.n_points[X_AXIS]) { return; }
+  for (j=0; j<heightmap.n_points[Y_AXIS]; j++) {
+    printPgmString(PSTR("[HMAP:"));
+    for (i=0; i<heightmap.n_points[X_AXIS]; i++) {
+      if (i) { serial_write(','); }
+      printFloat_CoordValue(0.001*heightmap.z[j*heightmap.n_points[X_AXIS]+i]);
+    }
+    report_util_feedback_line_feed();
+  }
+}
+#endif
+
+#ifdef ENABLE_PROGRAM_MODE
+// Prints the statistics of a completed '%' program as [PGM:lines,errors,stops]. Lines counts the
+// executed g-code lines, errors the lines rejected with an error, and stops the times motion came
+// to rest before the end of the program.
+void report_program_statistics(uint32_t lines, uint16_t errors, uint16_t stops)
+{
+  printPgmString(PSTR("[PGM:"));
+  print_uint32_base10(lines);
+  serial_write(',');
+  print_uint32_base10(errors);
+  serial_write(',');
+  print_uint32_base10(stops);
+  report_util_feedback_line_feed();
+}
+#endif
+
 void report_execute_startup_message(char *line, uint8_t status_code)
 {
   serial_write('>');
@@ -505,13 +605,21 @@ void report_echo_line_received(char *line)
  // specific needs, but the desired real-time data report must be as short as possible. This is
  // requires as it minimizes the computational overhead and allows grbl to keep running smoothly,
  // especially during g-code programs with fast, short line segments and high frequency reports (5-20Hz).
-void report_realtime_status() //data returned by typing in '?'
+void report_realtime_status(uint8_t nonblocking) //data returned by typing in '?'
 {
   uint8_t idx;
-  int32_t current_position[N_AXIS]; // Copy current state of the system position variable
-  memcpy(current_position,sys_position,sizeof(sys_position));
-  float print_position[N_AXIS];
-  system_convert_array_steps_to_mpos(print_position,current_position);
+  #ifdef REPORT_REALTIME_SNAPSHOT
+    st_snapshot_t snapshot; // Position, line number, and rate captured together.
+    st_get_snapshot(&snapshot);
+    int32_t *current_position = snapshot.position;
+  #else
+    int32_t current_position[N_AXIS]; // Copy current state of the system position variable
+    memcpy(current_position,sys_position,sizeof(sys_position));
+  #endif
+  #ifndef REPORT_INTEGER_POSITION
+    float print_position[N_AXIS];
+    system_convert_array_steps_to_mpos(print_position,current_position);
+  #endif
 
   // Report current machine state and sub-states
   serial_write('<');
@@ -538,19 +646,31 @@ void report_realtime_status() //data returned by typing in '?'
       // Apply work coordinate offsets and tool length offset to current position.
       wco[idx] = gc_state.coord_system[idx]+gc_state.coord_offset[idx];
       if (idx == TOOL_LENGTH_OFFSET_AXIS) { wco[idx] += gc_state.tool_length_offset; }
-      if (bit_isfalse(settings.status_report_mask,BITFLAG_RT_STATUS_POSITION_TYPE)) {
-        print_position[idx] -= wco[idx];
-      }
+      #ifndef REPORT_INTEGER_POSITION
+        if (bit_isfalse(settings.status_report_mask,BITFLAG_RT_STATUS_POSITION_TYPE)) {
+          print_position[idx] -= wco[idx];
+        }
+      #endif
     }
   }
 
   // Report machine position
-  if (bit_istrue(settings.status_report_mask,BITFLAG_RT_STATUS_POSITION_TYPE)) {
-    printPgmString(PSTR("|M:"));
-  } else {
-    printPgmString(PSTR("|W:"));
-  }
-  report_util_axis_values(print_position);
+  #ifdef REPORT_INTEGER_POSITION
+    if (bit_istrue(settings.status_report_mask,BITFLAG_RT_STATUS_POSITION_TYPE)) {
+      printPgmString(PSTR("|M:"));
+      report_util_axis_steps(current_position, NULL);
+    } else {
+      printPgmString(PSTR("|W:"));
+      report_util_axis_steps(current_position, wco);
+    }
+  #else
+    if (bit_istrue(settings.status_report_mask,BITFLAG_RT_STATUS_POSITION_TYPE)) {
+      printPgmString(PSTR("|M:"));
+    } else {
+      printPgmString(PSTR("|W:"));
+    }
+    report_util_axis_values(print_position);
+  #endif
 
   // Returns planner and serial read buffer states.
   #ifdef REPORT_FIELD_BUFFER_STATE
@@ -566,20 +686,28 @@ void report_realtime_status() //data returned by typing in '?'
   #ifdef USE_LINE_NUMBERS
     #ifdef REPORT_FIELD_LINE_NUMBERS
       // Report current line number
-      plan_block_t * cur_block = plan_get_current_block();
       printPgmString(PSTR("|L:"));    
-      uint32_t ln = cur_block->line_number;
-      if (cur_block != NULL) {
-        uint32_t ln = cur_block->line_number;
-        if (ln > 0) { printInteger(ln); }
-      } else {serial_write('0');}
+      #ifdef REPORT_REALTIME_SNAPSHOT
+        if (snapshot.line_number > 0) { printInteger(snapshot.line_number); }
+        else { serial_write('0'); }
+      #else
+        plan_block_t * cur_block = plan_get_current_block();
+        if (cur_block != NULL) {
+          uint32_t ln = cur_block->line_number;
+          if (ln > 0) { printInteger(ln); }
+        } else {serial_write('0');}
+      #endif
     #endif
   #endif
 
   // Report realtime feed speed
   #ifdef REPORT_FIELD_CURRENT_FEED_SPEED
     printPgmString(PSTR("|FS:"));
-    printFloat_RateValue(st_get_realtime_rate());
+    #ifdef REPORT_REALTIME_SNAPSHOT
+      printFloat_RateValue(snapshot.rate);
+    #else
+      printFloat_RateValue(st_get_realtime_rate());
+    #endif
     serial_write(',');
     printFloat(sys.spindle_speed,N_DECIMAL_RPMVALUE);
   #endif
@@ -600,6 +728,9 @@ void report_realtime_status() //data returned by typing in '?'
 
   #ifdef REPORT_FIELD_WORK_COORD_OFFSET
     if (sys.report_wco_counter > 0) { sys.report_wco_counter--; }
+    #ifdef ENABLE_AUTO_STATUS_REPORT
+      else if (nonblocking && (report_util_tx_available() < STATUS_REPORT_WCO_LENGTH+3)) { } // Still due next report.
+    #endif
     else {
       if (sys.state & (STATE_HOMING | STATE_CYCLE | STATE_HOLD | STATE_JOG)) {
         sys.report_wco_counter = (REPORT_WCO_REFRESH_BUSY_COUNT-1); // Reset counter for slow refresh
@@ -612,6 +743,9 @@ void report_realtime_status() //data returned by typing in '?'
 
   #ifdef REPORT_FIELD_OVERRIDES
     if (sys.report_ovr_counter > 0) { sys.report_ovr_counter--; }
+    #ifdef ENABLE_AUTO_STATUS_REPORT
+      else if (nonblocking && (report_util_tx_available() < STATUS_REPORT_OVR_LENGTH+3)) { } // Still due next report.
+    #endif
     else {
       if (sys.state & (STATE_HOMING | STATE_CYCLE | STATE_HOLD | STATE_JOG)) {
         sys.report_ovr_counter = (REPORT_OVR_REFRESH_BUSY_COUNT-1); // Reset counter for slow refresh
@@ -636,6 +770,30 @@ void report_realtime_status() //data returned by typing in '?'
   report_util_line_feed();
 }
 
+#ifdef ENABLE_EEPROM_IMAGE_COMMANDS
+// Prints the entire EEPROM as '[EE:aaaa:dd..dd:cc]' hex image lines for the '$EW=' command.
+void report_eeprom_image()
+{
+  uint16_t address = 0;
+  uint8_t idx, data, crc;
+  while (address < EEPROM_SIZE) {
+    printPgmString(PSTR("[EE:"));
+    print_uint8_base16(address >> 8);
+    print_uint8_base16(address & 0xFF);
+    serial_write(':');
+    crc = crc8_update(crc8_update(0, address >> 8), address & 0xFF);
+    for (idx=0; idx<EEPROM_IMAGE_BLOCK_SIZE; idx++) {
+      data = eeprom_get_char(address++);
+      crc = crc8_update(crc, data);
+      print_uint8_base16(data);
+    }
+    serial_write(':');
+    print_uint8_base16(crc);
+    report_util_feedback_line_feed();
+  }
+}
+#endif
+
 //Prints entire EEPROM contents
 void report_read_EEPROM()
 {
@@ -34,7 +34,7 @@
 #define STATUS_SOFT_LIMIT_ERROR 10
 #define STATUS_OVERFLOW 11
 #define STATUS_MAX_STEP_RATE_EXCEEDED 12
-//#define STATUS_ 13 //unused
+#define STATUS_EEPROM_IMAGE_ERROR 13
 #define STATUS_LINE_LENGTH_EXCEEDED 14
 #define STATUS_TRAVEL_EXCEEDED 15
 #define STATUS_INVALID_JOG_COMMAND 16
@@ -67,6 +67,7 @@
 #define ALARM_PROBE_FAIL_INITIAL    EXEC_ALARM_PROBE_FAIL_INITIAL
 #define ALARM_PROBE_FAIL_CONTACT    EXEC_ALARM_PROBE_FAIL_CONTACT
 #define ALARM_HOMING_FAIL_RESET     EXEC_ALARM_HOMING_FAIL_RESET
+#define ALARM_SPINDLE_AT_SPEED      EXEC_ALARM_SPINDLE_AT_SPEED
 #define ALARM_HOMING_FAIL_PULLOFF   EXEC_ALARM_HOMING_FAIL_PULLOFF
 #define ALARM_HOMING_FAIL_APPROACH  EXEC_ALARM_HOMING_FAIL_APPROACH
 
@@ -81,6 +82,7 @@
 #define MESSAGE_RESTORE_DEFAULTS 9
 #define MESSAGE_SPINDLE_RESTORE 10
 #define MESSAGE_SLEEP_MODE 11
+#define MESSAGE_PROGRAM_START 12
 
 // Define Grbl 'ok' response modes
 #define REPORT_RESPONSE_OK 0 //default mode //grbl replies 'ok'
@@ -107,8 +109,16 @@ void report_grbl_settings();
 // Prints an echo of the pre-parsed line received right before execution.
 void report_echo_line_received(char *line);
 
+#ifdef ENABLE_AUTO_STATUS_REPORT
+  // Worst-case status report lengths in bytes, assuming axis values of at most 10 characters.
+  #define STATUS_REPORT_BASE_LENGTH 87 // All fields through pin state, plus '>' and line ending.
+  #define STATUS_REPORT_WCO_LENGTH  35 // '|W:' and three axis values.
+  #define STATUS_REPORT_OVR_LENGTH  19 // '|Ov:' values and '|A:' spindle state.
+#endif
+
 // Prints realtime status report.  This is the data returned when user types '?'
-void report_realtime_status();
+// If nonblocking, the WCO and override fields are skipped unless the serial TX buffer has room.
+void report_realtime_status(uint8_t nonblocking);
 
 // Prints recorded probe position
 void report_probe_parameters();
@@ -126,7 +136,22 @@ void report_execute_startup_message(char *line, uint8_t status_code);
 // Prints build info and user info
 void report_build_info(char *line);
 
+#ifdef ENABLE_HEIGHTMAP
+  // Prints heightmap grid ($P)
+  void report_heightmap();
+#endif
+
+#ifdef ENABLE_PROGRAM_MODE
+  // Prints the statistics of a completed '%' program
+  void report_program_statistics(uint32_t lines, uint16_t errors, uint16_t stops);
+#endif
+
 //Prints entire EEPROM contents
 void report_read_EEPROM();
 
+#ifdef ENABLE_EEPROM_IMAGE_COMMANDS
+  // Prints the entire EEPROM as CRC-checked hex image lines ('$EB')
+  void report_eeprom_image();
+#endif
+
 #endif
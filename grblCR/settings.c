@@ -22,6 +22,42 @@
 #include "grbl.h"
 
 settings_t settings;
+settings_derived_t settings_derived;
+#ifdef ENABLE_EEPROM_IMAGE_COMMANDS
+  uint8_t settings_image_stale;
+#endif
+
+// Global settings are written in SETTINGS_N_CHUNK equal chunks. Only chunks flagged dirty since the
+// last write are re-programmed, along with the single checksum byte covering the whole struct.
+#define SETTINGS_N_CHUNK 8 // Max 8. One bit per chunk in settings_dirty.
+#define SETTINGS_CHUNK_SIZE ((sizeof(settings_t)+SETTINGS_N_CHUNK-1)/SETTINGS_N_CHUNK)
+#define SETTINGS_DIRTY_ALL 0xFF
+static uint8_t settings_dirty; // Bitmask of settings_t chunks changed since the last EEPROM write.
+#ifdef CACHE_COORDINATE_DATA
+  // RAM copy of all stored coordinate systems (G54-G59, G28, G30). Loaded by settings_init().
+  static float coord_cache[SETTING_INDEX_NCOORD+1][N_AXIS];
+  static uint8_t coord_cache_fail; // Bitmask of entries that failed the EEPROM checksum upon loading.
+#endif
+#ifdef ENABLE_SETTINGS_TRANSACTION
+  static uint8_t settings_transaction; // True while a '$T' transaction defers EEPROM writes.
+#endif
+#ifdef ENABLE_EEPROM_JOURNAL
+  // Journal record for frequently rewritten data. Stored with a trailing checksum byte per slot.
+  typedef struct {
+    uint8_t seq; // Append sequence number. Wraps.
+    uint8_t id;  // Coordinate index, or JOURNAL_ID_CAL_DATA plus calibration value index.
+    uint8_t data[sizeof(float)*N_AXIS];
+  } journal_record_t;
+  #define JOURNAL_SLOT_SIZE (sizeof(journal_record_t)+1)
+  #define JOURNAL_N_SLOTS ((EEPROM_ADDR_HEIGHTMAP-EEPROM_ADDR_JOURNAL)/JOURNAL_SLOT_SIZE)
+  #define JOURNAL_ID_OFFSET 1 // Byte offset of id in a slot. Written to JOURNAL_NONE to erase.
+  #define JOURNAL_ID_CAL_DATA (SETTING_INDEX_NCOORD+1)
+  #define JOURNAL_N_ID (JOURNAL_ID_CAL_DATA+8) // Up to QTY8 int16_t calibration values.
+  #define JOURNAL_NONE 0xFF
+  static uint8_t journal_slot[JOURNAL_N_ID]; // Slot of the newest record of each id, or JOURNAL_NONE.
+  static uint8_t journal_head; // Next free slot.
+  static uint8_t journal_seq;  // Sequence number of the next appended record.
+#endif
 
 const __flash settings_t defaults = {\
     .pulse_microseconds = DEFAULT_STEP_PULSE_MICROSECONDS,
@@ -60,10 +96,123 @@ const __flash settings_t defaults = {\
     .max_travel[Z_AXIS] = (-DEFAULT_Z_MAX_TRAVEL)};
 
 
+#ifdef ENABLE_EEPROM_JOURNAL
+// Wear-leveling journal for coordinate and calibration data. Instead of rewriting the same home
+// location, every write appends a record to the next journal slot. Reads use the newest record of
+// an id, if any, and otherwise the home location. When all slots are used, the newest records are
+// written back to their home locations and the journal is erased. Records are found by sequence
+// number, not slot order, so a power loss during compaction can only leave stale copies of data
+// already written home.
+static uint16_t journal_slot_addr(uint8_t slot)
+{
+  return(EEPROM_ADDR_JOURNAL + slot*JOURNAL_SLOT_SIZE);
+}
+
+
+static uint8_t journal_read_slot(uint8_t slot, journal_record_t *record)
+{
+  if (!(memcpy_from_eeprom_with_checksum((char*)record, journal_slot_addr(slot), sizeof(journal_record_t)))) {
+    return(false);
+  }
+  return(record->id < JOURNAL_N_ID);
+}
+
+
+// Scans the journal upon boot for the newest record of each id and the next free slot.
+static void settings_journal_init()
+{
+  journal_record_t record;
+  uint8_t id_seq[JOURNAL_N_ID];
+  uint8_t slot, newest = JOURNAL_NONE;
+  memset(journal_slot, JOURNAL_NONE, sizeof(journal_slot));
+  journal_head = 0;
+  journal_seq = 0;
+  for (slot=0; slot<JOURNAL_N_SLOTS; slot++) {
+    if (!journal_read_slot(slot, &record)) { continue; }
+    // NOTE: Sequence numbers only span one journal fill, so wrapping compares are valid.
+    if ((journal_slot[record.id] == JOURNAL_NONE) || ((int8_t)(record.seq-id_seq[record.id]) > 0)) {
+      journal_slot[record.id] = slot;
+      id_seq[record.id] = record.seq;
+    }
+    if ((newest == JOURNAL_NONE) || ((int8_t)(record.seq-journal_seq) > 0)) {
+      newest = slot;
+      journal_seq = record.seq;
+    }
+  }
+  if (newest != JOURNAL_NONE) {
+    journal_head = newest+1;
+    journal_seq++;
+  }
+}
+
+
+// Erases all journal slots. Reads fall back to the home locations.
+static void settings_journal_clear()
+{
+  uint8_t slot;
+  for (slot=0; slot<JOURNAL_N_SLOTS; slot++) { eeprom_put_char(journal_slot_addr(slot)+JOURNAL_ID_OFFSET, JOURNAL_NONE); }
+  memset(journal_slot, JOURNAL_NONE, sizeof(journal_slot));
+  journal_head = 0;
+}
+
+
+// Reads the newest journal record of an id. Returns false if there is none.
+static uint8_t settings_journal_read(uint8_t id, uint8_t *data, uint8_t size)
+{
+  journal_record_t record;
+  if (journal_slot[id] == JOURNAL_NONE) { return(false); }
+  if (!journal_read_slot(journal_slot[id], &record)) { return(false); }
+  memcpy(data, record.data, size);
+  return(true);
+}
+
+
+// Writes record data to the id's home location in EEPROM.
+static void settings_journal_write_home(uint8_t id, uint8_t *data)
+{
+  if (id < JOURNAL_ID_CAL_DATA) {
+    uint32_t addr = id*(sizeof(float)*N_AXIS+1) + EEPROM_ADDR_PARAMETERS;
+    memcpy_to_eeprom_with_checksum(addr, (char*)data, sizeof(float)*N_AXIS);
+  } else {
+    uint16_t addr = EEPROM_ADDR_CAL_DATA + 2*(id-JOURNAL_ID_CAL_DATA);
+    eeprom_put_char(addr, data[0]);   //MSB
+    eeprom_put_char(addr+1, data[1]); //LSB
+  }
+}
+
+
+// Writes the newest journal records to their home locations and erases the journal.
+static void settings_journal_compact()
+{
+  uint8_t data[sizeof(float)*N_AXIS];
+  uint8_t id;
+  // Home locations are written first. The journal remains valid until it is erased.
+  for (id=0; id<JOURNAL_N_ID; id++) {
+    if (settings_journal_read(id, data, sizeof(data))) { settings_journal_write_home(id, data); }
+  }
+  settings_journal_clear();
+}
+
+
+// Appends a record to the journal. Compacts the journal when full.
+static void settings_journal_write(uint8_t id, uint8_t *data, uint8_t size)
+{
+  journal_record_t record;
+  if (journal_head >= JOURNAL_N_SLOTS) { settings_journal_compact(); }
+  record.seq = journal_seq++;
+  record.id = id;
+  memset(record.data, 0, sizeof(record.data));
+  memcpy(record.data, data, size);
+  memcpy_to_eeprom_with_checksum(journal_slot_addr(journal_head), (char*)&record, sizeof(journal_record_t));
+  journal_slot[id] = journal_head++;
+}
+#endif
+
+
 // Method to store startup lines into EEPROM
 void settings_store_startup_line(uint8_t n, char *line)
 {
-  #ifdef FORCE_BUFFER_SYNC_DURING_EEPROM_WRITE
+  #if defined(FORCE_BUFFER_SYNC_DURING_EEPROM_WRITE) && !defined(EEPROM_WRITE_QUEUE)
     protocol_buffer_synchronize(); // A startup line may contain a motion and be executing. 
   #endif
   uint32_t addr = n*(LINE_BUFFER_SIZE+1)+EEPROM_ADDR_STARTUP_BLOCK;
@@ -91,11 +240,18 @@ void settings_store_manf_notes(char *line)
 // Method to store coord data parameters into EEPROM
 void settings_write_coord_data(uint8_t coord_select, float *coord_data)
 {
-  #ifdef FORCE_BUFFER_SYNC_DURING_EEPROM_WRITE
+  #if defined(FORCE_BUFFER_SYNC_DURING_EEPROM_WRITE) && !defined(EEPROM_WRITE_QUEUE)
     protocol_buffer_synchronize();
   #endif
-  uint32_t addr = coord_select*(sizeof(float)*N_AXIS+1) + EEPROM_ADDR_PARAMETERS;
-  memcpy_to_eeprom_with_checksum(addr,(char*)coord_data, sizeof(float)*N_AXIS);
+  #ifdef CACHE_COORDINATE_DATA
+    memcpy(coord_cache[coord_select], coord_data, sizeof(float)*N_AXIS);
+  #endif
+  #ifdef ENABLE_EEPROM_JOURNAL
+    settings_journal_write(coord_select, (uint8_t*)coord_data, sizeof(float)*N_AXIS);
+  #else
+    uint32_t addr = coord_select*(sizeof(float)*N_AXIS+1) + EEPROM_ADDR_PARAMETERS;
+    memcpy_to_eeprom_with_checksum(addr,(char*)coord_data, sizeof(float)*N_AXIS);
+  #endif
 }
 
 
@@ -103,16 +259,80 @@ void settings_write_coord_data(uint8_t coord_select, float *coord_data)
 // NOTE: This function can only be called in IDLE state.
 void write_global_settings()
 {
+  #ifdef ENABLE_SETTINGS_TRANSACTION
+    if (settings_transaction) { return; } // Written once upon '$T' commit.
+  #endif
+  if (!settings_dirty) { return; }
   eeprom_put_char(0, SETTINGS_VERSION); //byte 0x0000 in EEPROM
-  memcpy_to_eeprom_with_checksum(EEPROM_ADDR_GLOBAL, (char*)&settings, sizeof(settings_t));
+  memcpy_dirty_to_eeprom_with_checksum(EEPROM_ADDR_GLOBAL, (char*)&settings, sizeof(settings_t),
+                                       SETTINGS_CHUNK_SIZE, settings_dirty);
+  settings_dirty = 0;
+}
+
+
+// Flags the settings_t chunks spanned by a changed field for the next write_global_settings().
+static void settings_mark_dirty(void *field, uint8_t size)
+{
+  uint8_t idx = (uint8_t*)field - (uint8_t*)&settings;
+  uint8_t last = (idx+size-1)/SETTINGS_CHUNK_SIZE;
+  for (idx /= SETTINGS_CHUNK_SIZE; idx <= last; idx++) { settings_dirty |= bit(idx); }
 }
 
+
+#ifdef ENABLE_SETTINGS_TRANSACTION
+// Opens a '$T' settings transaction. Changed settings apply immediately, but the EEPROM is only
+// written when the transaction is committed, so a batch of settings costs a single checksum update.
+void settings_begin_transaction()
+{
+  settings_transaction = true;
+}
+
+
+// Commits all settings changed since settings_begin_transaction() to EEPROM.
+void settings_commit_transaction()
+{
+  settings_transaction = false;
+  write_global_settings();
+}
+
+
+uint8_t settings_transaction_is_open()
+{
+  return(settings_transaction);
+}
+#endif
+
 // Method to store Grbl calibration into EEPROM
 void settings_write_calibration_data(uint8_t eeprom_address, int16_t cal_data)
 {
-  eeprom_put_char( (EEPROM_ADDR_CAL_DATA+eeprom_address+0U),(cal_data >> 8) );    //MSB
-  eeprom_put_char( (EEPROM_ADDR_CAL_DATA+eeprom_address+1U),(cal_data & 0x00FF)); //LSB
+  #ifdef ENABLE_EEPROM_JOURNAL
+    uint8_t data[2] = { (cal_data >> 8), (cal_data & 0x00FF) }; //MSB, LSB
+    settings_journal_write(JOURNAL_ID_CAL_DATA+(eeprom_address/2), data, 2);
+  #else
+    eeprom_put_char( (EEPROM_ADDR_CAL_DATA+eeprom_address+0U),(cal_data >> 8) );    //MSB
+    eeprom_put_char( (EEPROM_ADDR_CAL_DATA+eeprom_address+1U),(cal_data & 0x00FF)); //LSB
+  #endif
+}
+
+#ifdef ENABLE_HEIGHTMAP
+// Method to store the heightmap grid into EEPROM
+// NOTE: This function can only be called in IDLE state.
+void settings_store_heightmap()
+{
+  memcpy_to_eeprom_with_checksum(EEPROM_ADDR_HEIGHTMAP, (char*)&heightmap, sizeof(heightmap_t));
+}
+
+
+// Reads the heightmap grid from EEPROM. Returns false and clears the heightmap if invalid.
+uint8_t settings_read_heightmap()
+{
+  if (!(memcpy_from_eeprom_with_checksum((char*)&heightmap, EEPROM_ADDR_HEIGHTMAP, sizeof(heightmap_t)))) {
+    memset(&heightmap, 0, sizeof(heightmap_t));
+    return(false);
+  }
+  return(true);
 }
+#endif
 
 // Method to store machine version info into EEPROM
 void settings_write_revision_data(uint8_t eeprom_address, int8_t version_data)
@@ -120,10 +340,35 @@ void settings_write_revision_data(uint8_t eeprom_address, int8_t version_data)
   eeprom_put_char( (EEPROM_ADDR_REVISION+eeprom_address),(version_data) );
 }
 
+// Recomputes values derived from settings for hot paths.
+void settings_update_derived()
+{
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) { settings_derived.mm_per_step[idx] = 1.0/settings.steps_per_mm[idx]; }
+  #ifdef REPORT_INTEGER_POSITION
+    float unit_scale = 1.0;
+    uint8_t decimals = N_DECIMAL_COORDVALUE_MM;
+    if (bit_istrue(settings.flags,BITFLAG_REPORT_INCHES)) {
+      unit_scale = INCH_PER_MM;
+      decimals = N_DECIMAL_COORDVALUE_INCH;
+    }
+    settings_derived.coord_decimals = decimals;
+    while (decimals--) { unit_scale *= 10.0; }
+    settings_derived.coord_unit_scale = unit_scale;
+    for (idx=0; idx<N_AXIS; idx++) { settings_derived.coord_scale[idx] = unit_scale*settings_derived.mm_per_step[idx]; }
+  #endif
+}
+
+
 // Method to restore EEPROM-saved Grbl global settings back to defaults.
 void settings_restore(uint8_t restore_flag) {
   if (restore_flag & SETTINGS_RESTORE_DEFAULTS) {  //$number= values 
     settings = defaults;
+    settings_update_derived();
+    settings_dirty = SETTINGS_DIRTY_ALL;
+    #ifdef ENABLE_SETTINGS_TRANSACTION
+      settings_transaction = false; // Restore always writes through.
+    #endif
     write_global_settings();
   }
 
@@ -131,6 +376,9 @@ void settings_restore(uint8_t restore_flag) {
     uint8_t idx;
     float coord_data[N_AXIS];
     memset(&coord_data, 0, sizeof(coord_data));
+    #ifdef ENABLE_EEPROM_JOURNAL
+      settings_journal_compact(); // Keeps journaled calibration data. Frees slots for the zeroed data.
+    #endif
     for (idx=0; idx <= SETTING_INDEX_NCOORD; idx++) { settings_write_coord_data(idx, coord_data); }
   }
 
@@ -187,9 +435,12 @@ uint8_t settings_read_manf_notes(char *line) //when finished, 'line' contains ma
 }
 
 
-// Read selected coordinate data from EEPROM. Updates pointed coord_data value.
-uint8_t settings_read_coord_data(uint8_t coord_select, float *coord_data)
+// Reads selected coordinate data from EEPROM. Invalid data is reset to zero and rewritten.
+static uint8_t settings_load_coord_data(uint8_t coord_select, float *coord_data)
 {
+  #ifdef ENABLE_EEPROM_JOURNAL
+    if (settings_journal_read(coord_select, (uint8_t*)coord_data, sizeof(float)*N_AXIS)) { return(true); }
+  #endif
   uint32_t addr = coord_select*(sizeof(float)*N_AXIS+1) + EEPROM_ADDR_PARAMETERS;
   if (!(memcpy_from_eeprom_with_checksum((char*)coord_data, addr, sizeof(float)*N_AXIS))) {
     // Reset with default zero vector
@@ -200,10 +451,30 @@ uint8_t settings_read_coord_data(uint8_t coord_select, float *coord_data)
   return(true);
 }
 
+
+// Read selected coordinate data. Updates pointed coord_data value. Served from RAM when cached.
+uint8_t settings_read_coord_data(uint8_t coord_select, float *coord_data)
+{
+  #ifdef CACHE_COORDINATE_DATA
+    memcpy(coord_data, coord_cache[coord_select], sizeof(float)*N_AXIS);
+    if (bit_istrue(coord_cache_fail, bit(coord_select))) {
+      bit_false(coord_cache_fail, bit(coord_select)); // Report the load failure only once, as before.
+      return(false);
+    }
+    return(true);
+  #else
+    return(settings_load_coord_data(coord_select, coord_data));
+  #endif
+}
+
 //reads calibration data from EEPROM.
 //two uint8_t bytes from EEPROM are converted to int16_t
 int16_t settings_read_calibration_data(uint8_t eeprom_offset)
 {
+  #ifdef ENABLE_EEPROM_JOURNAL
+    uint8_t data[2];
+    if (settings_journal_read(JOURNAL_ID_CAL_DATA+(eeprom_offset/2), data, 2)) { return((data[0]<<8) | data[1]); }
+  #endif
   uint8_t msb = eeprom_get_char(EEPROM_ADDR_CAL_DATA+eeprom_offset+0); //read MSB from EEPROM
   uint8_t lsb = eeprom_get_char(EEPROM_ADDR_CAL_DATA+eeprom_offset+1); //read LSB from EEPROM
   int16_t cal_data = (msb<<8) | lsb; //convert two uint8_t bytes to int16_t
@@ -258,6 +529,12 @@ uint8_t settings_store_global_setting(uint8_t parameter, float value) {
           case 2: settings.acceleration[parameter] = value*60*60; break; // Convert to mm/min^2 for grbl internal use.
           case 3: settings.max_travel[parameter] = -value; break;  // Store as negative for grbl internal use.
         }
+        #ifdef HOMING_VERIFY_CYCLE
+          // Steps/mm and max travel define where the limit switches are. The homed position is void.
+          if ((set_idx == 0) || (set_idx == 3)) { sys_home_trusted = 0; }
+        #endif
+        // NOTE: Axis setting arrays are contiguous in settings_t and ordered by set_idx.
+        settings_mark_dirty(&settings.steps_per_mm[parameter]+(set_idx*N_AXIS), sizeof(float));
         break; // Exit while-loop after setting has been configured and proceed to the EEPROM write call.
       } else {
         set_idx++;
@@ -269,17 +546,22 @@ uint8_t settings_store_global_setting(uint8_t parameter, float value) {
   } else {
     // Store non-axis Grbl settings
     uint8_t int_value = trunc(value);
+    void *field = &settings.flags; // Changed settings_t field. Boolean settings all live in flags.
+    uint8_t field_size = sizeof(settings.flags);
     switch(parameter) {
       case 0:
         if (int_value < 3) { return(STATUS_SETTING_STEP_PULSE_MIN); }
-        settings.pulse_microseconds = int_value; break;
-      case 1: settings.stepper_idle_lock_time = int_value; break;
+        settings.pulse_microseconds = int_value;
+        field = &settings.pulse_microseconds; field_size = sizeof(uint8_t); break;
+      case 1: settings.stepper_idle_lock_time = int_value; field = &settings.stepper_idle_lock_time; field_size = sizeof(uint8_t); break;
       case 2:
         settings.step_invert_mask = int_value;
+        field = &settings.step_invert_mask; field_size = sizeof(uint8_t);
         st_generate_step_dir_invert_masks(); // Regenerate step and direction port invert masks.
         break;
       case 3:
         settings.dir_invert_mask = int_value;
+        field = &settings.dir_invert_mask; field_size = sizeof(uint8_t);
         st_generate_step_dir_invert_masks(); // Regenerate step and direction port invert masks.
         break;
       case 4: // Reset to ensure change. Immediate re-init may cause problems.
@@ -295,9 +577,9 @@ uint8_t settings_store_global_setting(uint8_t parameter, float value) {
         else { settings.flags &= ~BITFLAG_INVERT_PROBE_PIN; }
         probe_configure_invert_mask(false);
         break;
-      case 10: settings.status_report_mask = int_value; break;
-      case 11: settings.junction_deviation = value; break;
-      case 12: settings.arc_tolerance = value; break;
+      case 10: settings.status_report_mask = int_value; field = &settings.status_report_mask; field_size = sizeof(uint8_t); break;
+      case 11: settings.junction_deviation = value; field = &settings.junction_deviation; field_size = sizeof(float); break;
+      case 12: settings.arc_tolerance = value; field = &settings.arc_tolerance; field_size = sizeof(float); break;
       case 13:
         if (int_value) { settings.flags |= BITFLAG_REPORT_INCHES; }
         else { settings.flags &= ~BITFLAG_REPORT_INCHES; }
@@ -321,19 +603,26 @@ uint8_t settings_store_global_setting(uint8_t parameter, float value) {
           settings.flags &= ~BITFLAG_SOFT_LIMIT_ENABLE; // Force disable soft-limits.
         }
         break;
-      case 23: settings.homing_dir_mask = int_value; break;
-      case 24: settings.homing_feed_rate = value; break;
-      case 25: settings.homing_seek_rate = value; break;
-      case 26: settings.homing_debounce_delay = int_value; break;
-      case 27: settings.homing_pulloff = value; break;
-      case 30: settings.rpm_max = value; spindle_init(); break; // Re-initialize spindle rpm calibration
-      case 31: settings.rpm_min = value; spindle_init(); break; // Re-initialize spindle rpm calibration
-      case 90: settings_write_revision_data(EEPROM_ADDR_REVISION_CR,  value); break; //$I:CR
-      case 92: settings_write_revision_data(EEPROM_ADDR_REVISION_PCB, value); break; //$I:PCB
+      case 23: settings.homing_dir_mask = int_value; field = &settings.homing_dir_mask; field_size = sizeof(uint8_t); break;
+      case 24: settings.homing_feed_rate = value; field = &settings.homing_feed_rate; field_size = sizeof(float); break;
+      case 25: settings.homing_seek_rate = value; field = &settings.homing_seek_rate; field_size = sizeof(float); break;
+      case 26: settings.homing_debounce_delay = int_value; field = &settings.homing_debounce_delay; field_size = sizeof(uint16_t); break;
+      case 27: settings.homing_pulloff = value; field = &settings.homing_pulloff; field_size = sizeof(float); break;
+      case 30: settings.rpm_max = value; field = &settings.rpm_max; field_size = sizeof(float); spindle_init(); break; // Re-initialize spindle rpm calibration
+      case 31: settings.rpm_min = value; field = &settings.rpm_min; field_size = sizeof(float); spindle_init(); break; // Re-initialize spindle rpm calibration
+      // Revision data is stored outside of settings_t. No settings chunk changes.
+      case 90: settings_write_revision_data(EEPROM_ADDR_REVISION_CR,  value); return(STATUS_OK); //$I:CR
+      case 92: settings_write_revision_data(EEPROM_ADDR_REVISION_PCB, value); return(STATUS_OK); //$I:PCB
       default:
         return(STATUS_INVALID_STATEMENT);
     }
+    settings_mark_dirty(field, field_size);
+    #ifdef HOMING_VERIFY_CYCLE
+      // Homing direction and pull-off define where the homed position is. It is void after a change.
+      if ((parameter == 23) || (parameter == 27)) { sys_home_trusted = 0; }
+    #endif
   }
+  settings_update_derived();
   write_global_settings();
   return(STATUS_OK);
 }
@@ -341,11 +630,23 @@ uint8_t settings_store_global_setting(uint8_t parameter, float value) {
 
 // Initialize the config subsystem
 void settings_init() {
+  #ifdef ENABLE_EEPROM_JOURNAL
+    settings_journal_init(); // Must precede any restore, which appends to the journal.
+  #endif
   if( !read_global_settings() ) {
     report_status_message(STATUS_SETTING_READ_FAIL);
     settings_restore(SETTINGS_RESTORE_ALL); // Force restore all EEPROM data.
     report_grbl_settings();
   }
+  settings_update_derived();
+  #ifdef CACHE_COORDINATE_DATA
+    uint8_t idx;
+    float coord_data[N_AXIS];
+    for (idx=0; idx <= SETTING_INDEX_NCOORD; idx++) {
+      if (!settings_load_coord_data(idx, coord_data)) { coord_cache_fail |= bit(idx); }
+      memcpy(coord_cache[idx], coord_data, sizeof(coord_data));
+    }
+  #endif
 }
 
 
@@ -51,6 +51,8 @@
 // Define status reporting boolean enable bit flags in settings.status_report_mask
 #define BITFLAG_RT_STATUS_POSITION_TYPE     bit(0)
 #define BITFLAG_RT_STATUS_BUFFER_STATE      bit(1)
+#define BITFLAG_RT_STATUS_AUTO_INTERVAL     bit(2) // ENABLE_AUTO_STATUS_REPORT
+#define BITFLAG_RT_STATUS_AUTO_CHANGE       bit(3) // ENABLE_AUTO_STATUS_REPORT
 
 // Define settings restore bitflags.
 #define SETTINGS_RESTORE_DEFAULTS bit(0)
@@ -72,7 +74,9 @@
 // the startup script. The lower half contains the global settings and space for future
 // developments.
 #define EEPROM_ADDR_GLOBAL         1U   //001:086 = $number= commands (e.g. $20=0)
-                                        //087:511 = UNUSED ("reserved for future use")
+#define EEPROM_ADDR_JOURNAL        87U  //087:386 = wear-leveling journal (ENABLE_EEPROM_JOURNAL)
+                                        //387:399 = UNUSED ("reserved for future use")
+#define EEPROM_ADDR_HEIGHTMAP      400U //400:511 = $PS heightmap grid (ENABLE_HEIGHTMAP)
 #define EEPROM_ADDR_PARAMETERS     512U //512:615 = WCS offsets (G54/G55...G59 stored here
                                         //616:655 = UNUSED
 #define EEPROM_ADDR_DATES          656U //656:663 = Original Manufacturing Date, Last RMA Date (YYMMDD)
@@ -83,6 +87,7 @@
 #define EEPROM_ADDR_MANF_NOTES     848U //848:929 = $B manufacturing/RMA notes stored here
                                         //930:941 = UNUSED
 #define EEPROM_ADDR_BUILD_INFO     942U //942:1023 = Additional $I data (added to end of hardcoded $I info)
+#define EEPROM_SIZE               1024U
 
 // Define EEPROM address indexing for coordinate parameters
 #define N_COORDINATE_SYSTEM 6  // Number of supported work coordinate systems (from index 1)
@@ -139,15 +144,45 @@ typedef struct { //values returned by $$ that $RST can restore
 } settings_t;
 extern settings_t settings;
 
+// Values derived from settings, precomputed for hot paths. Not stored in EEPROM.
+typedef struct {
+  float mm_per_step[N_AXIS]; // Reciprocal of settings.steps_per_mm. Avoids a divide per axis.
+  #ifdef REPORT_INTEGER_POSITION
+    float coord_scale[N_AXIS];    // Report units per step. Report unit is 10^-coord_decimals.
+    float coord_unit_scale;       // Report units per mm. Converts mm offsets.
+    uint8_t coord_decimals;       // N_DECIMAL_COORDVALUE_MM or _INCH, per $13.
+  #endif
+} settings_derived_t;
+extern settings_derived_t settings_derived;
+
+#ifdef ENABLE_EEPROM_IMAGE_COMMANDS
+  // Set when '$EW' rewrites EEPROM data held in RAM. Reloaded by settings_init() upon reset.
+  extern uint8_t settings_image_stale;
+#endif
+
 // Initialize the configuration subsystem (load settings from EEPROM)
 void settings_init();
 
+// Recomputes settings_derived. Called whenever settings are loaded or changed.
+void settings_update_derived();
+
 // Helper function to clear and restore EEPROM defaults
 void settings_restore(uint8_t restore_flag);
 
 // A helper method to set new settings from command line
 uint8_t settings_store_global_setting(uint8_t parameter, float value);
 
+#ifdef ENABLE_SETTINGS_TRANSACTION
+  // Defers global settings EEPROM writes until the transaction is committed
+  void settings_begin_transaction();
+
+  // Writes all global settings changed during the transaction to EEPROM
+  void settings_commit_transaction();
+
+  // Returns true while a settings transaction is open
+  uint8_t settings_transaction_is_open();
+#endif
+
 // Stores the protocol line variable as a startup line in EEPROM
 void settings_store_startup_line(uint8_t n, char *line);
 
@@ -183,5 +218,13 @@ uint8_t get_limit_pin_mask(uint8_t i);
 
 void settings_write_calibration_data(uint8_t eeprom_address, int16_t cal_data);
 
+#ifdef ENABLE_HEIGHTMAP
+  // Stores the heightmap grid into EEPROM
+  void settings_store_heightmap();
+
+  // Reads the heightmap grid from EEPROM. Returns false and clears the heightmap if invalid.
+  uint8_t settings_read_heightmap();
+#endif
+
 
 #endif
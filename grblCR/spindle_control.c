@@ -145,9 +145,35 @@ void spindle_sync(uint8_t state, float rpm)
   if (sys.state == STATE_CHECK_MODE) { return; }
   protocol_buffer_synchronize(); // Empty planner buffer to ensure spindle is set when programmed.
   spindle_set_state(state,rpm);
+  #ifdef SPINDLE_WAIT_AT_SPEED
+    if ((state != SPINDLE_DISABLE) && (rpm > 0.0)) { spindle_wait_at_speed(); }
+  #endif
 }
 
 
+#ifdef SPINDLE_WAIT_AT_SPEED
+// Waits until the spindle controller reports the actual RPM within the '0k' band of the goal RPM.
+// Realtime commands are executed while waiting. Issues an alarm, if the spindle doesn't reach
+// speed before the timeout.
+void spindle_wait_at_speed()
+{
+  delay_sec(SPINDLE_AT_SPEED_DELAY_MIN, DELAY_MODE_DWELL); // Let spindle controller register goal RPM.
+  uint16_t i = ceil(1000.0/DWELL_TIME_STEP*(SPINDLE_AT_SPEED_TIMEOUT-SPINDLE_AT_SPEED_DELAY_MIN));
+  while (spindle_get_actual_RPM_status() != SPINDLE_ACTUALRPM_WITHIN_0000TO0999_GOALRPM) {
+    if (sys.abort) { return; }
+    if (i-- == 0) {
+      mc_reset(); // Stop motors, if they are running.
+      system_set_exec_alarm(EXEC_ALARM_SPINDLE_AT_SPEED);
+      protocol_execute_realtime(); // Enter alarm state.
+      return;
+    }
+    protocol_execute_realtime();
+    _delay_ms(DWELL_TIME_STEP);
+  }
+}
+#endif
+
+
 // Determine spindle actualRPM status
 // The spindle CPU (32M1) sets two pins to indicate actual RPM status:
   //'0k': Spindle actualRPM within 0000:0999 of goalRPM //unoPinA2_low  //unoPinA4_low
@@ -64,4 +64,9 @@
 
   uint8_t spindle_get_actual_RPM_status(void);
 
+  #ifdef SPINDLE_WAIT_AT_SPEED
+    // Waits for the spindle to reach the goal RPM. Called by spindle_sync().
+    void spindle_wait_at_speed();
+  #endif
+
 #endif
@@ -33,6 +33,12 @@
 #define PREP_FLAG_HOLD_PARTIAL_BLOCK bit(1)
 #define PREP_FLAG_DECEL_OVERRIDE bit(3)
 
+#ifdef PLAN_SPINDLE_AND_DWELL_EVENTS
+  // Dwell blocks execute as stepless 1 msec timer ticks. Segments are sized like motion segments.
+  #define DWELL_CYCLES_PER_TICK (F_CPU/1000)
+  #define DWELL_TICKS_PER_SEGMENT (1000/ACCELERATION_TICKS_PER_SECOND)
+#endif
+
 // Define Adaptive Multi-Axis Step-Smoothing(AMASS) levels and cutoff frequencies. The highest level
 // frequency bin starts at 0Hz and ends at its cutoff frequency. The next lower level frequency bin
 // starts at the next higher cutoff frequency, and so on. The cutoff frequencies for each level must
@@ -66,6 +72,9 @@ typedef struct {
   uint32_t step_event_count;
   uint8_t direction_bits;
   uint8_t is_pwm_rate_adjusted; // Tracks motions that require constant laser power/rate
+  #if defined(REPORT_REALTIME_SNAPSHOT) && defined(USE_LINE_NUMBERS)
+    int32_t line_number; // Planner block line number. Reported once the block begins executing.
+  #endif
 } st_block_t;
 static st_block_t st_block_buffer[SEGMENT_BUFFER_SIZE-1];
 
@@ -83,6 +92,9 @@ typedef struct {
     uint8_t prescaler;      // Without AMASS, a prescaler is required to adjust for slow timing.
   #endif
   uint8_t spindle_pwm;
+  #ifdef REPORT_REALTIME_SNAPSHOT
+    float rate;             // Segment exit speed (mm/min). Reported while the segment executes.
+  #endif
 } segment_t;
 static segment_t segment_buffer[SEGMENT_BUFFER_SIZE];
 
@@ -111,6 +123,33 @@ typedef struct {
 } stepper_t;
 static stepper_t st;
 
+#ifdef REPORT_REALTIME_SNAPSHOT
+  // Executing segment data for realtime reports. Updated by the stepper ISR upon loading a segment.
+  // The sequence counter is incremented at the end of every stepper ISR that may have changed this
+  // data or sys_position, so the main program can detect and retry a torn read. See st_get_snapshot().
+  static volatile uint8_t st_snapshot_seq;
+  static float st_exec_rate;
+  #ifdef USE_LINE_NUMBERS
+    static int32_t st_exec_line_number;
+  #endif
+#endif
+
+#ifdef PROBE_SUBSTEP_INTERPOLATION
+  // Probe trip timing and Bresenham state. The edge is captured by the probe pin change ISR and
+  // the Bresenham state by the next stepper ISR tick, which also records sys_probe_position.
+  typedef struct {
+    uint16_t edge_ticks;       // Timer1 count at probe pin edge
+    uint16_t period_ticks;     // Timer1 step tick period (OCR1A) at probe pin edge
+    uint8_t edge_in_isr;       // Probe pin edge serviced while the stepper ISR was executing.
+    uint8_t is_late;           // Edge followed the step pulse of the tick that recorded the trip.
+    int32_t counter[N_AXIS];   // Bresenham counters, relative to their initial value.
+    uint32_t steps[N_AXIS];    // Bresenham counter increments per tick
+    uint32_t step_event_count;
+    uint8_t direction_bits;
+  } st_probe_t;
+  static st_probe_t st_probe;
+#endif
+
 // Step segment ring buffer indices
 static volatile uint8_t segment_buffer_tail;
 static uint8_t segment_buffer_head;
@@ -150,6 +189,11 @@ typedef struct {
 
   float inv_rate;    // Used by PWM laser mode to speed up segment calculations.
   uint8_t current_spindle_pwm; 
+
+  #ifdef ENABLE_NATIVE_ARCS
+    float arc_millimeters;      // Total length of the executing arc block (mm)
+    int32_t arc_steps[N_AXIS];  // Signed axis steps of the arc block checked out to segments
+  #endif
 } st_prep_t;
 static st_prep_t prep;
 
@@ -403,11 +447,26 @@ ISR(TIMER1_COMPA_vect)
       // Set real-time spindle output as segment is loaded, just prior to the first step.
       spindle_set_speed(st.exec_segment->spindle_pwm);  //TODO: why set spindle speed each interrupt (Realtime override?)?
 
+      #ifdef REPORT_REALTIME_SNAPSHOT
+        st_exec_rate = st.exec_segment->rate;
+        #ifdef USE_LINE_NUMBERS
+          st_exec_line_number = st.exec_block->line_number;
+        #endif
+      #endif
+
 
     } else {
       // Segment buffer empty. Shutdown.
       st_go_idle();
 
+      #ifdef REPORT_REALTIME_SNAPSHOT
+        st_exec_rate = 0.0;
+        #ifdef USE_LINE_NUMBERS
+          st_exec_line_number = 0;
+        #endif
+        st_snapshot_seq++;
+      #endif
+
       // Ensure pwm is set properly upon completion of rate-controlled motion.
       if (st.exec_block->is_pwm_rate_adjusted) { spindle_set_speed(SPINDLE_PWM_OFF_VALUE); }
 
@@ -471,6 +530,10 @@ ISR(TIMER1_COMPA_vect)
 
   st.step_outbits ^= step_port_invert_mask;  // Apply step port invert mask
 
+  #ifdef REPORT_REALTIME_SNAPSHOT
+    st_snapshot_seq++; // Position and executing segment data are consistent again.
+  #endif
+
   busy = false;
 }
 
@@ -533,6 +596,12 @@ void st_reset()
   segment_buffer_head = 0; // empty = tail
   segment_next_head = 1;
   busy = false;
+  #ifdef REPORT_REALTIME_SNAPSHOT
+    st_exec_rate = 0.0;
+    #ifdef USE_LINE_NUMBERS
+      st_exec_line_number = 0;
+    #endif
+  #endif
 
   st_generate_step_dir_invert_masks();
   st.dir_outbits = dir_port_invert_mask; // Initialize direction bits to default.
@@ -607,6 +676,118 @@ static uint8_t st_next_block_index(uint8_t block_index)
   return(block_index);
 }
 
+#ifdef PLAN_SPINDLE_AND_DWELL_EVENTS
+// Prepares a stepless segment of the executing dwell block. Called by st_prep_buffer() only.
+// Returns false, if a feed hold ends the dwell early. The remaining dwell time is retained.
+static uint8_t st_prep_dwell_segment()
+{
+  if (sys.step_control & STEP_CONTROL_EXECUTE_HOLD) {
+    bit_true(sys.step_control,STEP_CONTROL_END_MOTION);
+    return(false);
+  }
+
+  segment_t *prep_segment = &segment_buffer[segment_buffer_head];
+  prep_segment->st_block_index = prep.st_block_index;
+  prep_segment->n_step = DWELL_TICKS_PER_SEGMENT;
+  if (prep.steps_remaining < DWELL_TICKS_PER_SEGMENT) { prep_segment->n_step = prep.steps_remaining; }
+  prep_segment->cycles_per_tick = DWELL_CYCLES_PER_TICK;
+  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+    prep_segment->amass_level = 0;
+  #else
+    prep_segment->prescaler = 1; // prescaler: 0
+  #endif
+
+  // Apply the spindle state and speed of the dwell block.
+  if (sys.step_control & STEP_CONTROL_UPDATE_SPINDLE_PWM) {
+    if (pl_block->condition & PL_COND_SPINDLE_MASK) {
+      prep.current_spindle_pwm = spindle_compute_pwm_value(pl_block->spindle_speed);
+    } else {
+      sys.spindle_speed = 0.0;
+      prep.current_spindle_pwm = SPINDLE_PWM_OFF_VALUE;
+    }
+    bit_false(sys.step_control,STEP_CONTROL_UPDATE_SPINDLE_PWM);
+  }
+  prep_segment->spindle_pwm = prep.current_spindle_pwm;
+  #ifdef REPORT_REALTIME_SNAPSHOT
+    prep_segment->rate = 0.0; // Dwell. No motion.
+  #endif
+
+  // Segment complete! Increment segment buffer indices, so stepper ISR can immediately execute it.
+  segment_buffer_head = segment_next_head;
+  if ( ++segment_next_head == SEGMENT_BUFFER_SIZE ) { segment_next_head = 0; }
+
+  prep.steps_remaining -= prep_segment->n_step;
+  if (prep.steps_remaining == 0.0) { // End of dwell block.
+    pl_block = NULL;
+    plan_discard_current_block();
+  }
+  return(true);
+}
+#endif
+
+
+#ifdef ENABLE_NATIVE_ARCS
+// Loads the Bresenham data of an arc block segment ending mm_remaining from the end of the arc. The
+// segment axis steps are the difference between the arc step position at the segment end and the steps
+// already checked out, so rounding does not accumulate. The last segment ends on the block chord steps
+// to arrive exactly at the planned target. Each arc segment gets its own stepper block. This never
+// overruns the stepper block buffer, since it holds one block for every segment in the worst case.
+// Called by st_prep_buffer() only.
+static void st_prep_arc_segment(segment_t *prep_segment, float mm_remaining)
+{
+  int32_t target_steps[N_AXIS]; // Signed steps from arc start to segment end.
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    target_steps[idx] = pl_block->steps[idx];
+    if (pl_block->direction_bits & get_direction_pin_mask(idx)) { target_steps[idx] = -target_steps[idx]; }
+  }
+  if (mm_remaining > 0.0) {
+    uint8_t axis_0 = ARC_AXIS_0(pl_block->arc_axes);
+    uint8_t axis_1 = ARC_AXIS_1(pl_block->arc_axes);
+    uint8_t axis_linear = ARC_AXIS_LINEAR(pl_block->arc_axes);
+    float fraction = 1.0 - mm_remaining/prep.arc_millimeters;
+    float cos_T = cos(fraction*pl_block->arc_travel);
+    float sin_T = sin(fraction*pl_block->arc_travel);
+    float r_axis0 = pl_block->arc_radius[0];
+    float r_axis1 = pl_block->arc_radius[1];
+    target_steps[axis_0] = lround((r_axis0*cos_T - r_axis1*sin_T - r_axis0)*settings.steps_per_mm[axis_0]);
+    target_steps[axis_1] = lround((r_axis0*sin_T + r_axis1*cos_T - r_axis1)*settings.steps_per_mm[axis_1]);
+    target_steps[axis_linear] = lround(fraction*target_steps[axis_linear]);
+  }
+
+  prep.st_block_index = st_next_block_index(prep.st_block_index);
+  st_prep_block = &st_block_buffer[prep.st_block_index];
+  st_prep_block->direction_bits = 0;
+  #if defined(REPORT_REALTIME_SNAPSHOT) && defined(USE_LINE_NUMBERS)
+    st_prep_block->line_number = pl_block->line_number;
+  #endif
+  st_prep_block->is_pwm_rate_adjusted = false;
+  for (idx=0; idx<N_AXIS; idx++) {
+    int32_t delta = target_steps[idx]-prep.arc_steps[idx];
+    prep.arc_steps[idx] = target_steps[idx];
+    if (delta < 0) {
+      delta = -delta;
+      st_prep_block->direction_bits |= get_direction_pin_mask(idx);
+    }
+    // The virtual step count of the arc may fall a step short of an axis due to rounding.
+    if (prep_segment->n_step < delta) { prep_segment->n_step = delta; }
+    st_prep_block->steps[idx] = delta;
+  }
+
+  // The segment executes exactly its n_step ticks on this block, so all steps complete within it.
+  st_prep_block->step_event_count = max(prep_segment->n_step,1);
+  #ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+    for (idx=0; idx<N_AXIS; idx++) { st_prep_block->steps[idx] <<= 1; }
+    st_prep_block->step_event_count <<= 1;
+  #else
+    for (idx=0; idx<N_AXIS; idx++) { st_prep_block->steps[idx] <<= MAX_AMASS_LEVEL; }
+    st_prep_block->step_event_count <<= MAX_AMASS_LEVEL;
+  #endif
+  prep_segment->st_block_index = prep.st_block_index;
+}
+#endif
+
+
 /* Prepares step segment buffer. Continuously called from main program.
 
    The segment buffer is an intermediary buffer interface between the execution of steps
@@ -627,6 +808,13 @@ void st_prep_buffer()
 
   while (segment_buffer_tail != segment_next_head) { // Check if we need to fill the buffer.
 
+    #ifdef PLAN_SPINDLE_AND_DWELL_EVENTS
+      if ((pl_block != NULL) && (pl_block->condition & PL_COND_FLAG_DWELL)) {
+        if (!st_prep_dwell_segment()) { return; }
+        continue;
+      }
+    #endif
+
     // Determine if we need to load a new planner block or if the block needs to be recomputed.
     if (pl_block == NULL) {
 
@@ -635,11 +823,40 @@ void st_prep_buffer()
       else { pl_block = plan_get_current_block(); }
       if (pl_block == NULL) { return; } // No planner blocks. Exit.
 
+      #ifdef PLAN_SPINDLE_AND_DWELL_EVENTS
+        if (pl_block->condition & PL_COND_FLAG_DWELL) {
+          if (prep.recalculate_flag & PREP_FLAG_RECALCULATE) {
+            prep.recalculate_flag = false; // Resuming dwell after a feed hold. Remaining time retained.
+          } else {
+            // Load stepless Bresenham data for the dwell block.
+            prep.st_block_index = st_next_block_index(prep.st_block_index);
+            st_prep_block = &st_block_buffer[prep.st_block_index];
+            memset(st_prep_block,0,sizeof(st_block_t));
+            st_prep_block->step_event_count = 1; // Non-zero. Bresenham counters never overflow.
+            #if defined(REPORT_REALTIME_SNAPSHOT) && defined(USE_LINE_NUMBERS)
+              st_prep_block->line_number = pl_block->line_number;
+            #endif
+            prep.steps_remaining = pl_block->step_event_count; // Dwell ticks remaining.
+            prep.current_speed = 0.0;
+          }
+          bit_true(sys.step_control, STEP_CONTROL_UPDATE_SPINDLE_PWM);
+          continue; // Generate dwell segments.
+        }
+      #endif
+
       // Check if we need to only recompute the velocity profile or load a new block.
       if (prep.recalculate_flag & PREP_FLAG_RECALCULATE) {
         prep.recalculate_flag = false;
       } else {
 
+        #ifdef ENABLE_NATIVE_ARCS
+          if (pl_block->arc_travel != 0.0) {
+            // Arc blocks load the Bresenham stepping data with each segment.
+            prep.arc_millimeters = pl_block->millimeters;
+            memset(prep.arc_steps,0,sizeof(prep.arc_steps));
+          } else {
+        #endif
+
         // Load the Bresenham stepping data for the block.
         prep.st_block_index = st_next_block_index(prep.st_block_index);
 
@@ -648,6 +865,9 @@ void st_prep_buffer()
         // segment buffer finishes the prepped block, but the stepper ISR is still executing it.
         st_prep_block = &st_block_buffer[prep.st_block_index];
         st_prep_block->direction_bits = pl_block->direction_bits;
+        #if defined(REPORT_REALTIME_SNAPSHOT) && defined(USE_LINE_NUMBERS)
+          st_prep_block->line_number = pl_block->line_number;
+        #endif
        
         uint8_t idx;
         #ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
@@ -661,6 +881,10 @@ void st_prep_buffer()
           st_prep_block->step_event_count = pl_block->step_event_count << MAX_AMASS_LEVEL;
         #endif
 
+        #ifdef ENABLE_NATIVE_ARCS
+          }
+        #endif
+
         // Initialize segment buffer data for generating the segments.
         prep.steps_remaining = (float)pl_block->step_event_count;
         prep.step_per_mm = prep.steps_remaining/pl_block->millimeters;
@@ -677,7 +901,10 @@ void st_prep_buffer()
         }
       
         // Setup laser mode variables. PWM rate adjusted motions will always complete a motion with the
-        // spindle off. 
+        // spindle off. Arc segment blocks set it when they are loaded.
+        #ifdef ENABLE_NATIVE_ARCS
+          if (pl_block->arc_travel == 0.0)
+        #endif
         st_prep_block->is_pwm_rate_adjusted = false;
       }
 
@@ -900,6 +1127,9 @@ void st_prep_buffer()
       bit_false(sys.step_control,STEP_CONTROL_UPDATE_SPINDLE_PWM);
     }
     prep_segment->spindle_pwm = prep.current_spindle_pwm; // Reload segment PWM value
+    #ifdef REPORT_REALTIME_SNAPSHOT
+      prep_segment->rate = prep.current_speed;
+    #endif
 
 
     
@@ -928,6 +1158,10 @@ void st_prep_buffer()
       }
     }
 
+    #ifdef ENABLE_NATIVE_ARCS
+      if (pl_block->arc_travel != 0.0) { st_prep_arc_segment(prep_segment, mm_remaining); }
+    #endif
+
     // Compute segment step rate. Since steps are integers and mm distances traveled are not,
     // the end of every segment can have a partial step of varying magnitudes that are not
     // executed, because the stepper ISR requires whole steps due to the AMASS algorithm. To
@@ -1006,6 +1240,58 @@ void st_prep_buffer()
 }
 
 
+#ifdef PROBE_SUBSTEP_INTERPOLATION
+// Records the Timer1 count and step tick period when the probe pin edge occurs. Called by the
+// probe pin change ISR only. Timer1 restarts at every stepper ISR tick, so the ratio of the two
+// is the fraction of the step tick elapsed at the probe edge.
+void st_probe_capture_edge()
+{
+  st_probe.edge_ticks = TCNT1;
+  st_probe.period_ticks = OCR1A;
+  st_probe.edge_in_isr = busy;
+}
+
+
+// Records the Bresenham state of the executing segment at the probe trip. Called by
+// probe_state_monitor() in the stepper ISR, before this tick's step events are computed.
+// NOTE: The step pulse output at the start of this tick was computed by the previous tick, so
+// sys_position leads the physical position by one tick. If the probe edge was serviced within
+// this ISR ahead of the probe monitor, it follows that step pulse instead.
+void st_probe_capture_trip()
+{
+  st_probe.is_late = (st_probe.edge_in_isr && (st_probe.edge_ticks <= TCNT1));
+  st_probe.step_event_count = st.exec_block->step_event_count;
+  st_probe.direction_bits = st.exec_block->direction_bits;
+  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+    memcpy(st_probe.steps, st.steps, sizeof(st.steps));
+  #else
+    memcpy(st_probe.steps, st.exec_block->steps, sizeof(st.exec_block->steps));
+  #endif
+  st_probe.counter[X_AXIS] = st.counter_x;
+  st_probe.counter[Y_AXIS] = st.counter_y;
+  st_probe.counter[Z_AXIS] = st.counter_z;
+}
+
+
+// Computes the sub-step offset of the probe trip position from sys_probe_position in steps. The
+// Bresenham counters give the ideal line position relative to the integer step position at the
+// last computed tick, and the step tick fraction elapsed at the probe edge advances it along the line.
+void st_probe_get_substep_offset(float *offset)
+{
+  float tick_fraction = 0.0;
+  if (st_probe.period_ticks) { tick_fraction = (float)st_probe.edge_ticks/st_probe.period_ticks; }
+  if (tick_fraction > 1.0) { tick_fraction = 1.0; }
+  if (!st_probe.is_late) { tick_fraction -= 1.0; } // Edge preceded the last output step pulse.
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    offset[idx] = ((float)(st_probe.counter[idx]-(int32_t)(st_probe.step_event_count >> 1)) +
+                   tick_fraction*st_probe.steps[idx])/st_probe.step_event_count;
+    if (st_probe.direction_bits & get_direction_pin_mask(idx)) { offset[idx] = -offset[idx]; }
+  }
+}
+#endif
+
+
 // Called by realtime status reporting to fetch the current speed being executed. This value
 // however is not exactly the current speed, but the speed computed in the last step segment
 // in the segment buffer. It will always be behind by up to the number of segment blocks (-1)
@@ -1017,3 +1303,26 @@ float st_get_realtime_rate()
   }
   return 0.0f;
 }
+
+
+#ifdef REPORT_REALTIME_SNAPSHOT
+// Called by realtime status reporting to fetch the machine position, executing line number, and
+// speed as one consistent set. The stepper ISR can interrupt the copy at any byte, so the copy is
+// repeated until no stepper ISR ran during it. The speed and line number are those of the segment
+// actually being executed, rather than the last one prepped into the segment buffer.
+void st_get_snapshot(st_snapshot_t *snapshot)
+{
+  uint8_t seq;
+  do {
+    seq = st_snapshot_seq;
+    memcpy(snapshot->position,sys_position,sizeof(sys_position));
+    snapshot->rate = st_exec_rate;
+    #ifdef USE_LINE_NUMBERS
+      snapshot->line_number = st_exec_line_number;
+    #endif
+  } while (seq != st_snapshot_seq);
+  if (!(sys.state & (STATE_CYCLE | STATE_HOMING | STATE_HOLD | STATE_JOG))) {
+    snapshot->rate = 0.0;
+  }
+}
+#endif
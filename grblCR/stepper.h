@@ -64,6 +64,31 @@ void st_update_plan_block_parameters();
 // Called by realtime status reporting if realtime rate reporting is enabled in config.h.
 float st_get_realtime_rate();
 
+#ifdef REPORT_REALTIME_SNAPSHOT
+  // Machine position and executing motion data, captured together at a stepper ISR boundary.
+  typedef struct {
+    int32_t position[N_AXIS]; // Machine position in steps
+    float rate;               // Executing segment speed (mm/min). Zero when not in motion.
+    #ifdef USE_LINE_NUMBERS
+      int32_t line_number;    // Executing block line number. Zero when idle.
+    #endif
+  } st_snapshot_t;
+
+  // Called by realtime status reporting to fetch a consistent position and motion snapshot.
+  void st_get_snapshot(st_snapshot_t *snapshot);
+#endif
+
 void st_enable(void);
 
+#ifdef PROBE_SUBSTEP_INTERPOLATION
+  // Records the Timer1 count at the probe pin edge. Called by the probe pin change ISR.
+  void st_probe_capture_edge();
+
+  // Records the Bresenham state at the probe trip. Called by probe_state_monitor() in the stepper ISR.
+  void st_probe_capture_trip();
+
+  // Computes the probe trip position offset from sys_probe_position in steps. Main program only.
+  void st_probe_get_substep_offset(float *offset);
+#endif
+
 #endif
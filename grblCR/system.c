@@ -38,6 +38,66 @@ void system_execute_startup(char *line)
 }
 
 
+#ifdef ENABLE_EEPROM_IMAGE_COMMANDS
+// Reads two hex digits from the line into value. Returns false if not valid hex.
+static uint8_t read_hex_byte(char *line, uint8_t *char_counter, uint8_t *value)
+{
+  uint8_t idx, digit;
+  *value = 0;
+  for (idx=0; idx<2; idx++) {
+    digit = line[(*char_counter)++];
+    if ((digit >= '0') && (digit <= '9')) { digit -= '0'; }
+    else if ((digit >= 'A') && (digit <= 'F')) { digit -= 'A'-10; }
+    else { return(false); }
+    *value = (*value << 4) | digit;
+  }
+  return(true);
+}
+
+
+// Writes one '$EW=aaaa:dd..dd:cc' EEPROM image block, as printed by '$EB'. The CRC is checked over
+// the address and data before anything is written, and the block is read back after writing.
+static uint8_t system_write_eeprom_image(char *line)
+{
+  uint8_t data[EEPROM_IMAGE_BLOCK_SIZE];
+  uint8_t char_counter = 4; // Skip '$EW='
+  uint8_t addr_hi, addr_lo, crc_line, crc, n_bytes, idx;
+  if (!read_hex_byte(line, &char_counter, &addr_hi)) { return(STATUS_BAD_NUMBER_FORMAT); }
+  if (!read_hex_byte(line, &char_counter, &addr_lo)) { return(STATUS_BAD_NUMBER_FORMAT); }
+  if (line[char_counter++] != ':') { return(STATUS_INVALID_STATEMENT); }
+  crc = crc8_update(crc8_update(0, addr_hi), addr_lo);
+  n_bytes = 0;
+  while (line[char_counter] != ':') {
+    if (n_bytes == EEPROM_IMAGE_BLOCK_SIZE) { return(STATUS_OVERFLOW); }
+    if (!read_hex_byte(line, &char_counter, &data[n_bytes])) { return(STATUS_BAD_NUMBER_FORMAT); }
+    crc = crc8_update(crc, data[n_bytes++]);
+  }
+  char_counter++;
+  if (!read_hex_byte(line, &char_counter, &crc_line)) { return(STATUS_BAD_NUMBER_FORMAT); }
+  if ((n_bytes == 0) || (line[char_counter] != 0)) { return(STATUS_INVALID_STATEMENT); }
+  uint16_t address = ((uint16_t)addr_hi << 8) | addr_lo;
+  if (address+n_bytes > EEPROM_SIZE) { return(STATUS_OVERFLOW); }
+  if (crc != crc_line) { return(STATUS_EEPROM_IMAGE_ERROR); }
+
+  for (idx=0; idx<n_bytes; idx++) { eeprom_put_char(address+idx, data[idx]); }
+  #ifdef EEPROM_WRITE_QUEUE
+    eeprom_flush(); // Verify the programmed EEPROM, not the pending write queue.
+  #endif
+  for (idx=0; idx<n_bytes; idx++) {
+    if (eeprom_get_char(address+idx) != data[idx]) { return(STATUS_EEPROM_IMAGE_ERROR); } // Verify
+  }
+  // Settings, journal and coordinate data are cached in RAM. Writing them back from a stale copy
+  // would corrupt the new image, so all other commands are locked out until a reset reloads them.
+  if ((address < EEPROM_ADDR_HEIGHTMAP) ||
+      ((address < EEPROM_ADDR_DATES) && (address+n_bytes > EEPROM_ADDR_PARAMETERS))) {
+    if (!settings_image_stale) { report_feedback_message(MESSAGE_CRITICAL_EVENT); }
+    settings_image_stale = true;
+  }
+  return(STATUS_OK);
+}
+#endif
+
+
 // Directs and executes one line of formatted input from protocol_process. While mostly
 // incoming streaming g-code blocks, this also executes Grbl internal commands, such as
 // settings, initiating the homing cycle, and toggling switch states. This differs from
@@ -55,6 +115,9 @@ uint8_t system_execute_line(char *line)
     case 0 : report_grbl_help(); break; //entire line is '$' (protocol_main_loop() tacks '0' at end of each line)
 
     case 'J' : // $J = Jogging
+      #ifdef ENABLE_VELOCITY_JOG
+        if (line[2] == 'V') { return(jog_velocity_execute(line)); } // $JV = Velocity jogging
+      #endif
       // Execute only if in IDLE or JOG states.
       if (sys.state != STATE_IDLE && sys.state != STATE_JOG) { return(STATUS_IDLE_ERROR); }
       if(line[2] != '=') { return(STATUS_INVALID_STATEMENT); }
@@ -145,6 +208,10 @@ uint8_t system_execute_line(char *line)
 
         case 'E' : // $E = report entire EEPROM
           if ( line[2] == 0 ) { report_read_EEPROM(); }
+          #ifdef ENABLE_EEPROM_IMAGE_COMMANDS
+            else if ( (line[2] == 'B') && (line[3] == 0) ) { report_eeprom_image(); } // $EB = Print EEPROM image
+            else if ( (line[2] == 'W') && (line[3] == '=') ) { return(system_write_eeprom_image(line)); } // $EW=aaaa:dd..dd:cc
+          #endif
           else { return(STATUS_INVALID_STATEMENT); }
           break;
 
@@ -166,6 +233,51 @@ uint8_t system_execute_line(char *line)
           }
           break;
 
+        #ifdef ENABLE_HEIGHTMAP
+        case 'P' : // $P = Print heightmap. $PC/$PS/$PL = Clear/Store/Load heightmap. $P= Probe heightmap [IDLE]
+          if ( line[2] == 0 ) { report_heightmap(); break; }
+          if ( line[3] == 0 ) {
+            switch (line[2]) {
+              case 'C': memset(&heightmap, 0, sizeof(heightmap_t)); break; // Disables compensation.
+              case 'S': settings_store_heightmap(); break;
+              case 'L': if (!settings_read_heightmap()) { return(STATUS_SETTING_READ_FAIL); } break;
+              default: return(STATUS_INVALID_STATEMENT);
+            }
+            break;
+          }
+          if ( line[2] != '=' ) { return(STATUS_INVALID_STATEMENT); }
+          if (sys.state != STATE_IDLE) { return(STATUS_IDLE_ERROR); } // Probe only when idle.
+          {
+            float size[2] = {0.0, 0.0};
+            uint8_t n_points[2] = {HEIGHTMAP_MAX_POINTS_X, HEIGHTMAP_MAX_POINTS_Y};
+            float depth = 0.0;
+            float feed_rate = 0.0;
+            char letter;
+            char_counter = 3;
+            while (line[char_counter] != 0) {
+              letter = line[char_counter++];
+              if (!read_float(line, &char_counter, &value)) { return(STATUS_BAD_NUMBER_FORMAT); }
+              switch (letter) {
+                case 'X': size[X_AXIS] = value; break;
+                case 'Y': size[Y_AXIS] = value; break;
+                case 'Z': depth = value; break;
+                case 'F': feed_rate = value; break;
+                case 'I':
+                  if ((value < 2.0) || (value >= HEIGHTMAP_MAX_POINTS_X+1)) { return(STATUS_INVALID_STATEMENT); }
+                  n_points[X_AXIS] = trunc(value); break;
+                case 'J':
+                  if ((value < 2.0) || (value >= HEIGHTMAP_MAX_POINTS_Y+1)) { return(STATUS_INVALID_STATEMENT); }
+                  n_points[Y_AXIS] = trunc(value); break;
+                default: return(STATUS_INVALID_STATEMENT);
+              }
+            }
+            if ((size[X_AXIS] == 0.0) || (size[Y_AXIS] == 0.0)) { return(STATUS_INVALID_STATEMENT); }
+            if (depth <= 0.0) { return(STATUS_NEGATIVE_VALUE); }
+            if (feed_rate <= 0.0) { return(STATUS_GCODE_UNDEFINED_FEED_RATE); }
+            return(mc_probe_heightmap(size, n_points, depth, feed_rate));
+          }
+        #endif
+
         case 'S' : // $SLP = Puts Grbl to sleep [IDLE/ALARM]
           if ((line[2] != 'L') || (line[3] != 'P') || (line[4] != 0)) { return(STATUS_INVALID_STATEMENT); }
           system_set_exec_state_flag(EXEC_SLEEP); // Set to execute sleep mode immediately
@@ -223,6 +335,19 @@ uint8_t system_execute_line(char *line)
           mc_reset(); // Force reset to ensure settings are initialized correctly.
           break;
 
+        #ifdef ENABLE_SETTINGS_TRANSACTION
+          case 'T' : // $T = Open or commit a settings transaction [IDLE/ALARM]
+            if ( line[2] != 0 ) { return(STATUS_INVALID_STATEMENT); }
+            if (settings_transaction_is_open()) {
+              settings_commit_transaction();
+              report_feedback_message(MESSAGE_DISABLED);
+            } else {
+              settings_begin_transaction();
+              report_feedback_message(MESSAGE_ENABLED);
+            }
+            break;
+        #endif
+
         case 'N' : // $N = Startup lines. [IDLE/ALARM]
           if ( line[++char_counter] == 0 ) { // Print startup lines
             for (helper_var=0; helper_var < N_STARTUP_LINE; helper_var++) {
@@ -282,7 +407,7 @@ void system_flag_wco_change()
 float system_convert_axis_steps_to_mpos(int32_t *steps, uint8_t idx)
 {
   float pos;
-  pos = steps[idx]/settings.steps_per_mm[idx];
+  pos = steps[idx]*settings_derived.mm_per_step[idx];
   return(pos);
 }
 
@@ -308,6 +433,32 @@ uint8_t system_check_travel_limits(float *target)
 }
 
 
+#ifdef USE_SYSTEM_TICK
+// Configures the watchdog timer in interrupt-only mode as a ~16ms system tick. The watchdog is
+// otherwise unused and runs from its own oscillator, so the tick costs no timer or pin resources.
+void system_tick_init()
+{
+  uint8_t sreg = SREG;
+  cli();
+  MCUSR &= ~(1<<WDRF);
+  WDTCSR = (1<<WDCE) | (1<<WDE); // Timed sequence to change watchdog configuration.
+  WDTCSR = (1<<WDIE); // Interrupt mode, no system reset. Shortest 16ms prescale.
+  SREG = sreg;
+}
+
+
+// Watchdog tick. Advances the system tick and flags the main program to evaluate an automatic
+// status report.
+ISR(WDT_vect)
+{
+  sys_tick++;
+  #ifdef ENABLE_AUTO_STATUS_REPORT
+    system_set_exec_state_flag(EXEC_AUTO_REPORT);
+  #endif
+}
+#endif
+
+
 // Special handlers for setting and clearing Grbl's real-time execution flags.
 void system_set_exec_state_flag(uint8_t mask) {
   uint8_t sreg = SREG;
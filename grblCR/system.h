@@ -34,7 +34,7 @@
 #define EXEC_CYCLE_STOP     bit(2) // bitmask 00000100
 #define EXEC_FEED_HOLD      bit(3) // bitmask 00001000
 #define EXEC_RESET          bit(4) // bitmask 00010000
-//#define UNUSED    bit(5) // bitmask 00100000 //unused
+#define EXEC_AUTO_REPORT    bit(5) // bitmask 00100000
 #define EXEC_MOTION_CANCEL  bit(6) // bitmask 01000000
 #define EXEC_SLEEP          bit(7) // bitmask 10000000
 
@@ -45,6 +45,7 @@
 #define EXEC_ALARM_PROBE_FAIL_INITIAL         4
 #define EXEC_ALARM_PROBE_FAIL_CONTACT         5
 #define EXEC_ALARM_HOMING_FAIL_RESET          6
+#define EXEC_ALARM_SPINDLE_AT_SPEED           7
 #define EXEC_ALARM_HOMING_FAIL_PULLOFF        8
 #define EXEC_ALARM_HOMING_FAIL_APPROACH       9
 #define EXEC_ALARM_HOMING_FAIL_DUAL_APPROACH  10
@@ -129,6 +130,9 @@ extern system_t sys;
 // NOTE: These position variables may need to be declared as volatiles, if problems arise.
 extern int32_t sys_position[N_AXIS];      // Real-time machine (aka home) position vector in steps.
 extern int32_t sys_probe_position[N_AXIS]; // Last probe position in machine coordinates and steps.
+#ifdef HOMING_VERIFY_CYCLE
+  extern uint8_t sys_home_trusted; // Axes mask with a trusted position since their last homing cycle.
+#endif
 
 extern volatile uint8_t sys_probe_state;   // Probing state value.  Used to coordinate the probing cycle with stepper ISR.
 extern volatile uint8_t sys_rt_exec_state;   // Global realtime executor bitflag variable for state management. See EXEC bitmasks.
@@ -136,6 +140,14 @@ extern volatile uint8_t sys_rt_exec_alarm;   // Global realtime executor bitflag
 extern volatile uint8_t sys_rt_exec_motion_override; // Global realtime executor bitflag variable for motion-based overrides.
 extern volatile uint8_t sys_rt_exec_accessory_override; // Global realtime executor bitflag variable for spindle overrides.
 
+// Watchdog system tick. Times automatic status reports, the velocity jog keep-alive, and the program
+// mode auto-start fallback.
+#if defined(ENABLE_AUTO_STATUS_REPORT) || defined(ENABLE_VELOCITY_JOG) || defined(ENABLE_PROGRAM_MODE)
+  #define USE_SYSTEM_TICK
+  #define SYSTEM_TICK_MS 16 // Watchdog tick period in milliseconds.
+  extern volatile uint8_t sys_tick; // Free-running watchdog tick counter. Wraps at 256.
+#endif
+
 // Executes an internal system command, defined as a string starting with a '$'
 uint8_t system_execute_line(char *line);
 
@@ -155,6 +167,11 @@ void system_convert_array_steps_to_mpos(float *position, int32_t *steps);
 uint8_t system_check_travel_limits(float *target);
 
 // Special handlers for setting and clearing Grbl's real-time execution flags.
+#ifdef USE_SYSTEM_TICK
+  // Starts the watchdog timer interrupt used as the system tick.
+  void system_tick_init();
+#endif
+
 void system_set_exec_state_flag(uint8_t mask);
 void system_clear_exec_state_flag(uint8_t mask);
 void system_set_exec_alarm(uint8_t code);